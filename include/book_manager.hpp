@@ -0,0 +1,141 @@
+#ifndef BOOK_MANAGER_H
+#define BOOK_MANAGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "ingress.hpp"
+#include "orderbook.hpp"
+#include "spsc_ring.hpp"
+
+using SymbolId = std::uint32_t;
+
+// Pins the given thread to one CPU so a shard's book state stays hot in that
+// core's cache. No-op on platforms without an affinity API.
+inline void PinThreadToCore(std::thread& thread, unsigned core) {
+#if defined(__linux__)
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(core % std::thread::hardware_concurrency(), &cpuSet);
+  pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet);
+#else
+  (void)thread;
+  (void)core;
+#endif
+}
+
+// Owns one book per symbol and shards symbols across core-pinned worker
+// threads, one SPSC ring per shard. Every book is only ever touched by its
+// shard's worker, so the single-threaded fast path is preserved; the gateway
+// thread is the sole producer on all rings. Symbols must be registered
+// before Start().
+template <typename Book = OrderBook>
+class OrderBookManager {
+ public:
+  struct SymbolCommand {
+    SymbolId symbol;
+    OrderCommand command;
+  };
+
+  explicit OrderBookManager(std::size_t shardCount,
+                            std::size_t ringCapacity = 4096) {
+    shards_.reserve(shardCount);
+    for(std::size_t i = 0; i < shardCount; ++i) {
+      shards_.push_back(std::make_unique<Shard>(ringCapacity));
+    }
+  }
+
+  ~OrderBookManager() { Stop(); }
+
+  void AddSymbol(SymbolId symbol) {
+    if(running_.load()) {
+      throw std::logic_error("Symbols can't be added while workers run");
+    }
+    ShardOf(symbol).books.try_emplace(symbol);
+  }
+
+  void Start() {
+    if(running_.exchange(true)) return;
+    for(std::size_t i = 0; i < shards_.size(); ++i) {
+      Shard& shard = *shards_[i];
+      shard.worker = std::thread([this, &shard] { RunShard(shard); });
+      PinThreadToCore(shard.worker, static_cast<unsigned>(i));
+    }
+  }
+
+  void Stop() {
+    if(!running_.exchange(false)) return;
+    for(auto& shard : shards_) {
+      if(shard->worker.joinable()) shard->worker.join();
+    }
+  }
+
+  // Gateway thread only (each ring has a single producer). Returns false
+  // when the shard's ring is full.
+  bool Submit(SymbolId symbol, const OrderCommand& command) {
+    return ShardOf(symbol).ring.TryPush(SymbolCommand{symbol, command});
+  }
+
+  // Safe from any thread while workers run: goes through the book's seqlock.
+  DepthSnapshot LoadDepthSnapshot(SymbolId symbol) const {
+    return BookOf(symbol).LoadDepthSnapshot();
+  }
+
+  // Direct access for single-threaded use (replay, tests); don't mix with
+  // running workers.
+  Book& GetBook(SymbolId symbol) {
+    return const_cast<Book&>(BookOf(symbol));
+  }
+
+  std::size_t ShardCount() const { return shards_.size(); };
+
+ private:
+  struct Shard {
+    explicit Shard(std::size_t ringCapacity) : ring{ringCapacity} {}
+
+    SpscRing<SymbolCommand> ring;
+    std::unordered_map<SymbolId, Book> books;
+    std::thread worker;
+  };
+
+  Shard& ShardOf(SymbolId symbol) {
+    return *shards_[symbol % shards_.size()];
+  };
+
+  const Book& BookOf(SymbolId symbol) const {
+    const Shard& shard = *shards_[symbol % shards_.size()];
+    auto it = shard.books.find(symbol);
+    if(it == shard.books.end()) {
+      throw std::out_of_range("Unknown symbol id (" + std::to_string(symbol) +
+                              ")");
+    }
+    return it->second;
+  };
+
+  void RunShard(Shard& shard) {
+    while(running_.load(std::memory_order_relaxed)) {
+      shard.ring.Drain(
+          [&shard](const SymbolCommand& entry) {
+            auto it = shard.books.find(entry.symbol);
+            if(it != shard.books.end()) ApplyCommand(it->second, entry.command);
+          },
+          256);
+    }
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<bool> running_{false};
+};
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef BROADCAST_RING_H
+#define BROADCAST_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Bounded single-producer/multi-consumer broadcast ring. The producer
+// publishes wait-free - it stamps the slot, copies the value in, and never
+// looks at any consumer state - and each consumer walks the ring with its
+// own private cursor, so consumers never contend with each other either.
+// A consumer that falls more than a full ring behind gets overwritten; it
+// detects that as a gap from the per-slot generation stamp and resyncs from
+// a snapshot instead of ever making the producer wait. Capacity must be a
+// power of two.
+//
+// Per-slot stamps work like a tiny seqlock keyed by absolute position: slot
+// for position p holds p while the producer is writing it and p + 1 once the
+// value is complete, so a reader expecting position p accepts exactly p + 1
+// and re-checks it after copying to reject torn reads.
+template <typename T>
+class BroadcastRing {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Broadcast payloads are copied byte-wise between threads");
+
+ public:
+  explicit BroadcastRing(std::size_t capacity)
+      : mask_{capacity - 1}, slots_(capacity) {
+    if(capacity == 0 || (capacity & (capacity - 1)) != 0) {
+      throw std::invalid_argument(
+          "BroadcastRing capacity must be a power of two");
+    }
+    // Stamp each slot as "pre-history" so fresh readers see Empty, not
+    // garbage.
+    for(std::size_t i = 0; i < capacity; ++i) {
+      slots_[i].sequence.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // Producer side; wait-free regardless of how far behind any consumer is.
+  void Publish(const T& value) {
+    std::uint64_t position = head_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[position & mask_];
+    slot.sequence.store(position, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.value = value;
+    slot.sequence.store(position + 1, std::memory_order_release);
+    head_.store(position + 1, std::memory_order_release);
+  }
+
+  // Next position the producer will write; where an overrun reader resyncs.
+  std::uint64_t Head() const {
+    return head_.load(std::memory_order_acquire);
+  };
+
+  std::size_t Capacity() const { return mask_ + 1; };
+
+ private:
+  template <typename U>
+  friend class BroadcastReader;
+
+  struct Slot {
+    std::atomic<std::uint64_t> sequence;
+    T value;
+  };
+
+  std::size_t mask_;
+  std::vector<Slot> slots_;
+  alignas(64) std::atomic<std::uint64_t> head_{0};
+};
+
+// One consumer's view of a BroadcastRing: a private cursor plus the poll
+// loop. Each drop-copy/risk/publisher thread owns its own reader.
+template <typename T>
+class BroadcastReader {
+ public:
+  enum class Poll {
+    Empty,  // nothing new published
+    Item,   // `out` holds the next event
+    Gap,    // overrun: events were lost and the cursor jumped to the head
+  };
+
+  explicit BroadcastReader(const BroadcastRing<T>& ring)
+      : ring_{&ring}, cursor_{ring.Head()} {}
+
+  // On Gap the caller has missed events irrecoverably and should rebuild its
+  // state from a snapshot (e.g. LoadDepthSnapshot) before polling on.
+  Poll TryPoll(T& out) {
+    const auto& slot = ring_->slots_[cursor_ & ring_->mask_];
+    std::uint64_t before = slot.sequence.load(std::memory_order_acquire);
+    if(before < cursor_ + 1) return Poll::Empty;  // not yet (fully) written
+    if(before > cursor_ + 1) return Resync();     // lapped by the producer
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    out = slot.value;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if(slot.sequence.load(std::memory_order_relaxed) != before) {
+      return Resync();  // overwritten mid-copy
+    }
+    ++cursor_;
+    return Poll::Item;
+  }
+
+  std::uint64_t Cursor() const { return cursor_; };
+
+ private:
+  Poll Resync() {
+    cursor_ = ring_->Head();
+    return Poll::Gap;
+  }
+
+  const BroadcastRing<T>* ring_;
+  std::uint64_t cursor_;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef FANOUT_H
+#define FANOUT_H
+
+#include <cstdint>
+
+#include "broadcast_ring.hpp"
+#include "orderbook.hpp"
+
+// One broadcast event: a trade print or a depth delta, flattened into a
+// trivially copyable record so it can cross the ring byte-wise. The unused
+// half is left zeroed rather than packed into a union; fan-out volume is a
+// fraction of order flow and the flat layout keeps consumers branch-light.
+struct BookEvent {
+  enum class Kind : std::uint8_t { Trade, Depth };
+
+  Kind kind;
+  TradeInfos bidTrade{};
+  TradeInfos askTrade{};
+  DepthUpdate depth{};
+};
+
+// Hooks a book's trade sink and depth listener up to a BroadcastRing so the
+// matching thread publishes every trade and depth delta wait-free, and any
+// number of consumer threads (drop-copy, risk, md-publisher) follow along
+// with their own BroadcastReader cursors. A reader that reports a gap
+// rebuilds from the book's LoadDepthSnapshot and polls on.
+template <typename Book>
+class BookFanout {
+ public:
+  explicit BookFanout(Book& book, std::size_t ringCapacity = 4096)
+      : ring_{ringCapacity} {
+    book.SetTradeSink([this](const Trade& trade) {
+      BookEvent event{BookEvent::Kind::Trade};
+      event.bidTrade = trade.GetBidTrade();
+      event.askTrade = trade.GetAskTrade();
+      ring_.Publish(event);
+    });
+    book.SetDepthListener([this](const DepthUpdate& update) {
+      BookEvent event{BookEvent::Kind::Depth};
+      event.depth = update;
+      ring_.Publish(event);
+    });
+  }
+
+  BroadcastReader<BookEvent> MakeReader() const {
+    return BroadcastReader<BookEvent>{ring_};
+  };
+
+  const BroadcastRing<BookEvent>& Ring() const { return ring_; };
+
+ private:
+  BroadcastRing<BookEvent> ring_;
+};
+
+#endif
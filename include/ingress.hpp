@@ -0,0 +1,66 @@
+#ifndef INGRESS_H
+#define INGRESS_H
+
+#include <cstdint>
+
+#include "orderbook.hpp"
+#include "spsc_ring.hpp"
+
+// Fixed-size order command handed from a network thread to the matching
+// thread. Plain data on purpose: it gets copied into the ring, journaled,
+// and decoded straight off the wire.
+struct OrderCommand {
+  enum class Type : std::uint8_t { NewOrder, Cancel, Modify };
+
+  Type type;
+  Side side;
+  OrderType orderType;
+  OrderId orderId;
+  Quantity quantity;
+  Price price;
+};
+
+// Trades surface through the book's sink or buffer, not a return value.
+template <typename Book>
+void ApplyCommand(Book& book, const OrderCommand& command) {
+  switch(command.type) {
+    case OrderCommand::Type::NewOrder:
+      book.AddOrder(command.orderId, command.orderType, command.quantity,
+                    command.price, command.side);
+      break;
+    case OrderCommand::Type::Cancel:
+      book.CancelOrder(command.orderId);
+      break;
+    case OrderCommand::Type::Modify:
+      book.ModifyOrder(OrderModify{command.orderId, command.side,
+                                   command.quantity, command.price});
+      break;
+  }
+}
+
+// Ingestion pipeline in front of a book: a network thread Submits commands
+// into the SPSC ring and the matching thread Drains them in batches, so the
+// per-order handoff is one ring slot copy instead of a mutex and a
+// shared_ptr.
+template <typename Book>
+class BookIngress {
+ public:
+  explicit BookIngress(std::size_t capacity = 4096) : ring_{capacity} {}
+
+  // Producer (network thread). Returns false when the ring is full and the
+  // caller has to back off.
+  bool Submit(const OrderCommand& command) { return ring_.TryPush(command); };
+
+  // Consumer (matching thread): applies up to maxBatch queued commands to
+  // the book and returns how many it processed.
+  std::size_t Drain(Book& book, std::size_t maxBatch = 256) {
+    return ring_.Drain(
+        [&book](const OrderCommand& command) { ApplyCommand(book, command); },
+        maxBatch);
+  };
+
+ private:
+  SpscRing<OrderCommand> ring_;
+};
+
+#endif
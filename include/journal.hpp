@@ -0,0 +1,123 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include "ingress.hpp"
+#include "wire.hpp"
+
+// Append-only write-ahead journal of order commands in the binary wire
+// format, backed by a memory-mapped, pre-sized file. Append is a 16-byte
+// memcpy into the mapping - no syscall on the hot path; the kernel writes
+// pages back on its own schedule (call Sync for a durability point). The
+// file is zero-filled up front and 0 is not a valid WireType, so the end of
+// the journal is simply the first zero type byte - both reopen and Replay
+// scan to it.
+class Journal {
+ public:
+  Journal(const std::string& path, std::size_t capacityBytes)
+      : capacity_{capacityBytes} {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if(fd_ < 0) {
+      throw std::runtime_error("Journal can't open " + path);
+    }
+    if(::ftruncate(fd_, static_cast<off_t>(capacity_)) != 0) {
+      ::close(fd_);
+      throw std::runtime_error("Journal can't size " + path);
+    }
+    void* mapping = ::mmap(nullptr, capacity_, PROT_READ | PROT_WRITE,
+                           MAP_SHARED, fd_, 0);
+    if(mapping == MAP_FAILED) {
+      ::close(fd_);
+      throw std::runtime_error("Journal can't map " + path);
+    }
+    base_ = static_cast<std::byte*>(mapping);
+    writeOffset_ = ScanEnd();
+  }
+
+  ~Journal() {
+    if(base_ != nullptr) {
+      ::msync(base_, capacity_, MS_ASYNC);
+      ::munmap(base_, capacity_);
+    }
+    if(fd_ >= 0) ::close(fd_);
+  }
+
+  Journal(const Journal&) = delete;
+  Journal& operator=(const Journal&) = delete;
+
+  // Hot path: one bounds check and a memcpy into the mapping.
+  void Append(const OrderCommand& command) {
+    if(writeOffset_ + sizeof(WireNewOrder) > capacity_) {
+      throw std::runtime_error("Journal is full");
+    }
+    writeOffset_ += EncodeCommand(command, base_ + writeOffset_);
+  }
+
+  // Forces written pages to disk; for periodic durability points, not the
+  // per-order path.
+  void Sync() { ::msync(base_, writeOffset_, MS_SYNC); }
+
+  std::size_t Size() const { return writeOffset_; };
+  std::size_t Capacity() const { return capacity_; };
+
+  // Rebuilds a book from the journal's contents, e.g. at startup after a
+  // crash. Returns the number of bytes replayed.
+  template <typename Book>
+  std::size_t Replay(Book& book) const {
+    return FeedWireBuffer(book, base_, writeOffset_);
+  }
+
+  // Replays only the tail from `offset` on - the part written after the
+  // snapshot the book was just restored from.
+  template <typename Book>
+  std::size_t ReplayFrom(Book& book, std::size_t offset) const {
+    if(offset >= writeOffset_) return 0;
+    return FeedWireBuffer(book, base_ + offset, writeOffset_ - offset);
+  }
+
+ private:
+  // Finds where existing journal contents end: the first zero type byte.
+  std::size_t ScanEnd() const {
+    std::size_t offset = 0;
+    while(offset < capacity_) {
+      WireType type = static_cast<WireType>(
+          std::to_integer<std::uint8_t>(base_[offset]));
+      std::size_t messageSize = WireMessageSize(type);
+      if(messageSize == 0 || offset + messageSize > capacity_) break;
+      offset += messageSize;
+    }
+    return offset;
+  }
+
+  std::size_t capacity_;
+  int fd_{-1};
+  std::byte* base_{nullptr};
+  std::size_t writeOffset_{0};
+};
+
+// Ingress decorator that journals every command before it reaches the book:
+// the write-ahead ordering that makes replay-based recovery sound.
+template <typename Book>
+class JournaledBook {
+ public:
+  JournaledBook(Book& book, Journal& journal)
+      : book_{book}, journal_{journal} {}
+
+  void Apply(const OrderCommand& command) {
+    journal_.Append(command);
+    ApplyCommand(book_, command);
+  }
+
+ private:
+  Book& book_;
+  Journal& journal_;
+};
+
+#endif
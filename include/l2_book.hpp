@@ -0,0 +1,137 @@
+#ifndef L2_BOOK_H
+#define L2_BOOK_H
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#include "ladder.hpp"
+#include "orderbook.hpp"
+
+using Volume = Quantity;
+
+// What an L2 level holds: just the aggregate volume. empty() is the ladder's
+// signal that the level is gone.
+struct L2Level {
+  Volume volume{0};
+
+  bool empty() const { return volume <= 0; };
+};
+
+// Aggregate-only book for consuming external market-data feeds: it keeps
+// per-price volume and nothing else - no order FIFOs, no order-id index - so
+// a feed update is one ladder lookup and an add. Grew out of the old
+// LimitOrderBook prototype in src/test.cpp, which kept Price -> Volume maps
+// the same way.
+template <typename BidLadder, typename AskLadder>
+class BasicL2Book {
+ public:
+  BasicL2Book() = default;
+
+  // Ladder configuration, e.g. the dense ladder's price range and tick.
+  template <typename... Args>
+  explicit BasicL2Book(Args... args) : bids_{args...}, asks_{args...} {}
+
+  // Feed delta: adds volume to a level, creating it if needed.
+  void AddVolume(Side side, Price price, Volume volume) {
+    if(side == Side::Buy)
+      bids_.GetOrAdd(price).volume += volume;
+    else
+      asks_.GetOrAdd(price).volume += volume;
+  }
+
+  // Feed delta: takes volume off a level and drops the level at zero. This
+  // is the path the old prototype's mDeleteOrder never finished.
+  void RemoveVolume(Side side, Price price, Volume volume) {
+    if(side == Side::Buy)
+      RemoveVolume(bids_, price, volume);
+    else
+      RemoveVolume(asks_, price, volume);
+  }
+
+  // Absolute feed update: sets a level's volume outright; zero removes it.
+  // Matches the LevelChanged/LevelRemoved semantics of DepthUpdate events.
+  void SetLevel(Side side, Price price, Volume volume) {
+    if(side == Side::Buy)
+      SetLevel(bids_, price, volume);
+    else
+      SetLevel(asks_, price, volume);
+  }
+
+  // Best of book; an empty side reads as {0, 0}.
+  LevelInfo BestBid() const {
+    return bids_.Empty() ? LevelInfo{0, 0}
+                         : LevelInfo{bids_.BestPrice(), BestBidVolume()};
+  }
+
+  LevelInfo BestAsk() const {
+    return asks_.Empty() ? LevelInfo{0, 0}
+                         : LevelInfo{asks_.BestPrice(), BestAskVolume()};
+  }
+
+  OrderBookLevelInfos GetLevelInfos(
+      std::size_t depth = std::numeric_limits<std::size_t>::max()) const {
+    LevelInfos bidsInfos, asksInfos;
+    bidsInfos.reserve(std::min(depth, bids_.LevelCount()));
+    asksInfos.reserve(std::min(depth, asks_.LevelCount()));
+
+    bids_.ForEachLevel([&](Price price, const L2Level& level) {
+      bidsInfos.push_back(LevelInfo{price, level.volume});
+      return bidsInfos.size() < depth;
+    });
+    asks_.ForEachLevel([&](Price price, const L2Level& level) {
+      asksInfos.push_back(LevelInfo{price, level.volume});
+      return asksInfos.size() < depth;
+    });
+
+    return OrderBookLevelInfos{bidsInfos, asksInfos};
+  }
+
+ private:
+  template <typename Ladder>
+  void RemoveVolume(Ladder& ladder, Price price, Volume volume) {
+    L2Level* level = ladder.Find(price);
+    if(level == nullptr) return;
+    level->volume -= volume;
+    if(level->empty()) {
+      level->volume = 0;
+      ladder.OnLevelEmpty(price);
+    }
+  }
+
+  template <typename Ladder>
+  void SetLevel(Ladder& ladder, Price price, Volume volume) {
+    if(volume <= 0) {
+      L2Level* level = ladder.Find(price);
+      if(level != nullptr) {
+        level->volume = 0;
+        ladder.OnLevelEmpty(price);
+      }
+      return;
+    }
+    ladder.GetOrAdd(price).volume = volume;
+  }
+
+  // const_cast shims: the ladders' BestLevel is non-const, and mutating
+  // nothing here is plain from the call.
+  Volume BestBidVolume() const {
+    return const_cast<BidLadder&>(bids_).BestLevel().volume;
+  };
+  Volume BestAskVolume() const {
+    return const_cast<AskLadder&>(asks_).BestLevel().volume;
+  };
+
+  BidLadder bids_;
+  AskLadder asks_;
+};
+
+// The general-purpose L2 book over tree ladders.
+using L2Book = BasicL2Book<MapLadder<std::greater<Price>, L2Level>,
+                           MapLadder<std::less<Price>, L2Level>>;
+
+// Contiguous-ladder L2 book for bounded tick ranges; construct with
+// (minPrice, maxPrice, tick).
+using DenseL2Book = BasicL2Book<DenseLadder<Side::Buy, L2Level>,
+                                DenseLadder<Side::Sell, L2Level>>;
+
+#endif
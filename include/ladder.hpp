@@ -0,0 +1,189 @@
+#ifndef LADDER_H
+#define LADDER_H
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+enum class Side { Buy, Sell };
+
+using Quantity = std::int32_t;
+using Price = std::int32_t;
+using OrderId = std::int32_t;
+
+// Index of an order inside the pool's arena; stable for the order's lifetime.
+using OrderIndex = std::uint32_t;
+inline constexpr OrderIndex kNullIndex =
+    std::numeric_limits<OrderIndex>::max();
+
+// A price level: the head/tail of its intrusive order FIFO plus running
+// aggregates, kept up to date on every add/cancel/fill so depth snapshots
+// never have to walk the orders.
+struct Level {
+  OrderIndex head{kNullIndex};
+  OrderIndex tail{kNullIndex};
+  Quantity totalQuantity{0};
+  std::uint32_t orderCount{0};
+
+  bool empty() const { return head == kNullIndex; };
+};
+
+// Red-black-tree price ladder, the classic std::map book. Works for an
+// unbounded price range; best-of-book is the map's first entry. Tree nodes
+// of emptied levels are parked on a free list and reused, so cancel-heavy
+// flow churning the same prices stops round-tripping through the global
+// allocator. ValueT is whatever a level holds - the full order FIFO by
+// default, or just an aggregate for L2-only books - and needs an empty()
+// telling the ladder when the level is gone.
+template <typename Compare, typename ValueT = Level>
+class MapLadder {
+ public:
+  bool Empty() const { return levels_.empty(); };
+  std::size_t LevelCount() const { return levels_.size(); };
+
+  Price BestPrice() const { return levels_.begin()->first; };
+  ValueT& BestLevel() { return levels_.begin()->second; };
+
+  ValueT& GetOrAdd(Price price) {
+    auto it = levels_.find(price);
+    if(it != levels_.end()) return it->second;
+    if(!freeNodes_.empty()) {
+      auto handle = std::move(freeNodes_.back());
+      freeNodes_.pop_back();
+      handle.key() = price;
+      handle.mapped() = ValueT{};
+      return levels_.insert(std::move(handle)).position->second;
+    }
+    return levels_[price];
+  };
+
+  ValueT* Find(Price price) {
+    auto it = levels_.find(price);
+    return it == levels_.end() ? nullptr : &it->second;
+  };
+
+  // Any price keys into the tree; here so callers can pre-flight a price
+  // before committing other state, uniformly across ladder types.
+  void ValidatePrice(Price) const {};
+
+  void OnLevelEmpty(Price price) {
+    auto handle = levels_.extract(price);
+    if(handle && freeNodes_.size() < kMaxFreeNodes) {
+      freeNodes_.push_back(std::move(handle));
+    }
+  };
+
+  // Visits levels best-first; the callback returns false to stop early.
+  template <typename F>
+  void ForEachLevel(F&& f) const {
+    for(const auto& [price, level] : levels_) {
+      if(!f(price, level)) break;
+    }
+  }
+
+ private:
+  // Bounds how many parked nodes a quiet book keeps around.
+  static constexpr std::size_t kMaxFreeNodes = 1024;
+
+  std::map<Price, ValueT, Compare> levels_;
+  std::vector<typename std::map<Price, ValueT, Compare>::node_type>
+      freeNodes_;
+};
+
+// Dense price ladder: one slot per tick in a bounded [minPrice, maxPrice]
+// range, indexed by (price - minPrice) / tick. Best-of-book is a cursor into
+// the array, so lookup is O(1) and creating a level never allocates. The
+// cursor only ever walks over levels that were once occupied, which stays
+// cheap as long as trading clusters around the touch.
+template <Side side, typename ValueT = Level>
+class DenseLadder {
+ public:
+  DenseLadder(Price minPrice, Price maxPrice, Price tick)
+      : minPrice_{minPrice},
+        tick_{tick},
+        levels_(static_cast<std::size_t>((maxPrice - minPrice) / tick) + 1) {}
+
+  bool Empty() const { return levelCount_ == 0; };
+  std::size_t LevelCount() const { return levelCount_; };
+
+  Price BestPrice() const { return minPrice_ + bestSlot_ * tick_; };
+  ValueT& BestLevel() { return levels_[bestSlot_]; };
+
+  ValueT& GetOrAdd(Price price) {
+    std::int64_t slot = SlotOf(price);
+    ValueT& level = levels_[slot];
+    if(level.empty()) {
+      ++levelCount_;
+      if(bestSlot_ == kNoBest || Better(slot, bestSlot_)) bestSlot_ = slot;
+    }
+    return level;
+  };
+
+  ValueT* Find(Price price) {
+    ValueT& level = levels_[SlotOf(price)];
+    return level.empty() ? nullptr : &level;
+  };
+
+  // Throws if the price is off this ladder's grid, without touching any
+  // level; callers pre-flight a price here before committing other state.
+  void ValidatePrice(Price price) const { SlotOf(price); };
+
+  void OnLevelEmpty(Price price) {
+    --levelCount_;
+    if(levelCount_ == 0) {
+      bestSlot_ = kNoBest;
+      return;
+    }
+    std::int64_t slot = SlotOf(price);
+    if(slot != bestSlot_) return;
+    do {
+      bestSlot_ += (side == Side::Buy) ? -1 : 1;
+    } while(levels_[bestSlot_].empty());
+  };
+
+  // Visits levels best-first; the callback returns false to stop early.
+  template <typename F>
+  void ForEachLevel(F&& f) const {
+    if(levelCount_ == 0) return;
+    std::size_t remaining = levelCount_;
+    for(std::int64_t slot = bestSlot_; remaining > 0;
+        slot += (side == Side::Buy) ? -1 : 1) {
+      const ValueT& level = levels_[slot];
+      if(level.empty()) continue;
+      if(!f(static_cast<Price>(minPrice_ + slot * tick_), level)) return;
+      --remaining;
+    }
+  }
+
+ private:
+  static constexpr std::int64_t kNoBest = -1;
+
+  std::int64_t SlotOf(Price price) const {
+    // Check the signed delta before dividing: division truncates toward
+    // zero, so a price just below minPrice (or off the tick grid) would
+    // otherwise silently bin into a neighbouring slot.
+    std::int64_t delta = static_cast<std::int64_t>(price) - minPrice_;
+    if(delta < 0 || delta % tick_ != 0 ||
+       delta / tick_ >= static_cast<std::int64_t>(levels_.size())) {
+      throw std::out_of_range("Price (" + std::to_string(price) +
+                              ") is outside the dense ladder's grid");
+    }
+    return delta / tick_;
+  };
+
+  // Whether slot a is closer to the touch than slot b.
+  static bool Better(std::int64_t a, std::int64_t b) {
+    return side == Side::Buy ? a > b : a < b;
+  };
+
+  Price minPrice_;
+  Price tick_;
+  std::vector<ValueT> levels_;
+  std::int64_t bestSlot_{kNoBest};
+  std::size_t levelCount_{0};
+};
+
+#endif
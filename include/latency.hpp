@@ -0,0 +1,113 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+// Cheap monotonic cycle counter for hot-path timestamping.
+inline std::uint64_t ReadTsc() {
+#if defined(__x86_64__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  std::uint64_t value;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+  return value;
+#else
+  return static_cast<std::uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// Operations the book instruments individually.
+enum class BookOp : std::size_t { AddOrder, CancelOrder, Match, kCount };
+
+// Copy of a histogram a background thread can crunch without racing the
+// matching thread.
+struct HistogramSnapshot {
+  std::array<std::uint64_t, 65> buckets{};
+
+  std::uint64_t Count() const {
+    std::uint64_t count = 0;
+    for(std::uint64_t bucket : buckets) count += bucket;
+    return count;
+  }
+
+  // Upper bound (in recorded units, i.e. cycles) of the bucket holding the
+  // requested percentile.
+  std::uint64_t Percentile(double p) const {
+    std::uint64_t target = static_cast<std::uint64_t>(p * Count());
+    std::uint64_t seen = 0;
+    for(std::size_t i = 0; i < buckets.size(); ++i) {
+      seen += buckets[i];
+      if(seen >= target) return i == 0 ? 0 : (std::uint64_t{1} << i) - 1;
+    }
+    return 0;
+  }
+};
+
+// HDR-style power-of-two-bucketed histogram. Record is a single relaxed
+// counter bump on the hot path; a background thread snapshots the buckets
+// with relaxed loads, which is as consistent as an export needs to be.
+class LatencyHistogram {
+ public:
+  void Record(std::uint64_t value) {
+    buckets_[std::bit_width(value)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  HistogramSnapshot Load() const {
+    HistogramSnapshot snapshot;
+    for(std::size_t i = 0; i < buckets_.size(); ++i) {
+      snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    return snapshot;
+  }
+
+ private:
+  std::array<std::atomic<std::uint64_t>, 65> buckets_{};
+};
+
+// Profiler policy that compiles to nothing: the default, so the
+// zero-overhead build stays zero-overhead.
+struct NullProfiler {
+  struct Scope {
+    Scope(NullProfiler&, BookOp) {}
+  };
+};
+
+// Profiler policy that rdtsc-timestamps each scoped operation into a
+// per-operation histogram.
+class TscProfiler {
+ public:
+  class Scope {
+   public:
+    Scope(TscProfiler& profiler, BookOp op)
+        : profiler_{profiler}, op_{op}, start_{ReadTsc()} {}
+    ~Scope() { profiler_.Record(op_, ReadTsc() - start_); }
+
+   private:
+    TscProfiler& profiler_;
+    BookOp op_;
+    std::uint64_t start_;
+  };
+
+  void Record(BookOp op, std::uint64_t cycles) {
+    histograms_[static_cast<std::size_t>(op)].Record(cycles);
+  }
+
+  HistogramSnapshot Load(BookOp op) const {
+    return histograms_[static_cast<std::size_t>(op)].Load();
+  }
+
+ private:
+  std::array<LatencyHistogram, static_cast<std::size_t>(BookOp::kCount)>
+      histograms_;
+};
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef ORDER_INDEX_H
+#define ORDER_INDEX_H
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include "ladder.hpp"
+
+// Flat open-addressing hash from OrderId to pool OrderIndex. Slots live in
+// one contiguous array (12 bytes each), probed linearly from a Fibonacci
+// hash of the id, so a lookup touches one or two cache lines instead of
+// chasing an unordered_map bucket node. Deletion backward-shifts the
+// following probe run, so there are no tombstones and probe lengths stay
+// short; the table doubles at 70% load.
+class OrderIdIndex {
+ public:
+  explicit OrderIdIndex(std::size_t capacity = 1024) { Rehash(capacity); }
+
+  std::size_t Size() const { return size_; };
+
+  bool Contains(OrderId orderId) const { return Find(orderId) != nullptr; };
+
+  const OrderIndex* Find(OrderId orderId) const {
+    for(std::size_t slot = Home(orderId);; slot = Next(slot)) {
+      if(!slots_[slot].occupied) return nullptr;
+      if(slots_[slot].key == orderId) return &slots_[slot].value;
+    }
+  };
+
+  OrderIndex* Find(OrderId orderId) {
+    return const_cast<OrderIndex*>(
+        static_cast<const OrderIdIndex*>(this)->Find(orderId));
+  };
+
+  void Insert(OrderId orderId, OrderIndex value) {
+    if((size_ + 1) * 10 > slots_.size() * 7) Rehash(slots_.size() * 2);
+    std::size_t slot = Home(orderId);
+    while(slots_[slot].occupied) {
+      if(slots_[slot].key == orderId) {
+        slots_[slot].value = value;
+        return;
+      }
+      slot = Next(slot);
+    }
+    slots_[slot] = Slot{orderId, value, true};
+    ++size_;
+  };
+
+  void Erase(OrderId orderId) {
+    std::size_t slot = Home(orderId);
+    while(true) {
+      if(!slots_[slot].occupied) return;
+      if(slots_[slot].key == orderId) break;
+      slot = Next(slot);
+    }
+    --size_;
+    // Backward-shift: pull every following entry of the probe run into the
+    // hole unless it already sits at (or before) its home slot.
+    std::size_t hole = slot;
+    for(std::size_t probe = Next(slot); slots_[probe].occupied;
+        probe = Next(probe)) {
+      std::size_t home = Home(slots_[probe].key);
+      // `probe` may move into `hole` only if its home lies outside
+      // (hole, probe] in circular order.
+      bool movable = hole <= probe ? (home <= hole || home > probe)
+                                   : (home <= hole && home > probe);
+      if(movable) {
+        slots_[hole] = slots_[probe];
+        hole = probe;
+      }
+    }
+    slots_[hole].occupied = false;
+  };
+
+ private:
+  struct Slot {
+    OrderId key;
+    OrderIndex value;
+    bool occupied{false};
+  };
+
+  std::size_t Home(OrderId orderId) const {
+    // Fibonacci hashing: the high bits of the multiply spread the dense
+    // sequential ids a gateway assigns evenly across the table.
+    return static_cast<std::size_t>(
+        (static_cast<std::uint64_t>(static_cast<std::uint32_t>(orderId)) *
+         0x9E3779B97F4A7C15ULL) >>
+        shift_);
+  };
+
+  std::size_t Next(std::size_t slot) const {
+    return (slot + 1) & (slots_.size() - 1);
+  };
+
+  void Rehash(std::size_t capacity) {
+    std::size_t rounded = 16;
+    while(rounded < capacity) rounded <<= 1;
+    std::vector<Slot> old = std::move(slots_);
+    slots_.assign(rounded, Slot{});
+    shift_ = 64 - std::countr_zero(rounded);
+    size_ = 0;
+    for(const Slot& slot : old) {
+      if(slot.occupied) Insert(slot.key, slot.value);
+    }
+  };
+
+  std::vector<Slot> slots_;
+  std::size_t size_{0};
+  unsigned shift_{60};
+};
+
+#endif
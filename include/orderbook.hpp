@@ -0,0 +1,1464 @@
+#ifndef ORDERBOOK_H
+#define ORDERBOOK_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <array>
+
+#include "ladder.hpp"
+#include "order_index.hpp"
+#include "latency.hpp"
+#include "seqlock.hpp"
+
+enum class OrderType {
+  FillAndKill,
+  GoodTillCancel,
+  Market,
+  Stop,
+  StopLimit,
+  GoodForDay
+};
+
+// Session clock for order expiry; units are whatever the owning thread's
+// clock ticks in (the book never reads a clock itself).
+using Timestamp = std::uint64_t;
+
+// Market orders (and stop-markets once triggered) carry no limit of their
+// own; this sentinel marks them on the sweep path, where their fills report
+// at the resting order's price.
+inline constexpr Price kMarketOrderPrice = std::numeric_limits<Price>::min();
+
+using ParticipantId = std::int32_t;
+inline constexpr ParticipantId kNoParticipant = -1;
+
+// What to do when the two orders at the front of the crossing queues belong
+// to the same participant. Checked per potential fill in O(1): the
+// participant id rides in the OrderNode the match loop already has loaded.
+enum class SelfTradePolicy {
+  None,          // allow the self-trade
+  CancelNewest,  // drop whichever of the two entered the book later
+  CancelOldest,  // drop whichever entered the book earlier
+  Decrement,     // work both down by the overlap without printing a trade
+};
+
+struct LevelInfo {
+  Price price;
+  Quantity quantity;
+};
+
+using LevelInfos = std::vector<LevelInfo>;
+
+class OrderBookLevelInfos {
+ public:
+  OrderBookLevelInfos(LevelInfos& bidsInfos, LevelInfos& asksInfos)
+      : bids_{bidsInfos}, asks_{asksInfos} {};
+
+  LevelInfos GetBidsLevelInfos() const { return bids_; };
+  LevelInfos GetAsksLevelInfos() const { return asks_; };
+
+ private:
+  LevelInfos bids_;
+  LevelInfos asks_;
+};
+
+class Order {
+ public:
+  Order(OrderId orderId, OrderType orderType, Quantity quantity, Price price,
+        Side side)
+      : orderId_{orderId},
+        orderType_{orderType},
+        initialQuantity_{quantity},
+        remainingQuantity_{quantity},
+        price_{price},
+        side_{side} {}
+
+  OrderId GetOrderId() const { return orderId_; };
+  OrderType GetOrderType() const { return orderType_; };
+  Quantity GetInitialQuantity() const { return initialQuantity_; };
+  Quantity GetRemainingQuantity() const { return remainingQuantity_; };
+  Price GetPrice() const { return price_; };
+  Side GetSide() const { return side_; };
+
+  bool isFilled() const { return GetRemainingQuantity() == 0; };
+  void Fill(Quantity quantity) {
+    if(quantity > GetRemainingQuantity()) {
+      throw std::logic_error("Order Id (" + std::to_string(GetOrderId()) +
+                             ") can't get filled more than its remaining "
+                             "quantity");
+    }
+    remainingQuantity_ -= quantity;
+  }
+
+ private:
+  OrderId orderId_;
+  OrderType orderType_;
+  Quantity initialQuantity_;
+  Quantity remainingQuantity_;
+  Price price_;
+  Side side_;
+};
+
+using OrderPointer = std::shared_ptr<Order>;
+using OrderPointers = std::list<OrderPointer>;
+
+class OrderModify {
+ public:
+  OrderModify(OrderId orderId, Side side, Quantity quantity, Price price)
+      : orderId_{orderId}, side_{side}, quantity_{quantity}, price_{price} {}
+
+  OrderId GetOrderId() const { return orderId_; };
+  Side GetOrderSide() const { return side_; };
+  Quantity GetOrderQuantity() const { return quantity_; };
+  Price GetOrderPrice() const { return price_; };
+
+  OrderPointer ToOrderPointer(OrderType orderType) const {
+    return std::make_shared<Order>(GetOrderId(), orderType, GetOrderQuantity(),
+                                   GetOrderPrice(), GetOrderSide());
+  }
+
+ private:
+  OrderId orderId_;
+  Side side_;
+  Quantity quantity_;
+  Price price_;
+};
+
+struct TradeInfos {
+  OrderId orderId;
+  Price price;
+  Quantity quantity;
+  // Who was behind the order; lets fan-out consumers (drop-copy, risk)
+  // attribute fills without a separate order-owner lookup.
+  ParticipantId participant{kNoParticipant};
+};
+
+class Trade {
+ public:
+  Trade(const TradeInfos& bidTrade, const TradeInfos& askTrade)
+      : bidTrade_{bidTrade}, askTrade_{askTrade} {}
+
+  const TradeInfos& GetBidTrade() const { return bidTrade_; };
+  const TradeInfos& GetAskTrade() const { return askTrade_; };
+
+ private:
+  TradeInfos bidTrade_;
+  TradeInfos askTrade_;
+};
+
+using Trades = std::vector<Trade>;
+
+// Per-fill callback; when one is installed the book hands every trade to it
+// instead of buffering.
+using TradeSink = std::function<void(const Trade&)>;
+
+// One incremental market-data event: a level appeared, its aggregate
+// changed, it went away, or the best price on a side moved. Downstream
+// feeds consume O(changes) of these instead of copying the whole depth.
+struct DepthUpdate {
+  enum class Type : std::uint8_t {
+    LevelAdded,
+    LevelChanged,
+    LevelRemoved,
+    BestChanged,  // price/quantity are the new best, or 0/0 for an empty side
+  };
+
+  Type type;
+  Side side;
+  Price price;
+  Quantity quantity;
+};
+
+using DepthListener = std::function<void(const DepthUpdate&)>;
+
+// Compile-time matching policy: venue semantics that are fixed at
+// deployment get decided here so each configuration compiles to a
+// branch-minimal match loop instead of paying runtime tests. The default
+// reproduces the book's existing behavior.
+struct DefaultMatchPolicy {
+  // When true, self-trade handling consults the runtime
+  // SetSelfTradePolicy setting; when false, kSelfTradePolicy is baked in
+  // and the check folds away entirely for None.
+  static constexpr bool kRuntimeSelfTradePolicy = true;
+  static constexpr SelfTradePolicy kSelfTradePolicy = SelfTradePolicy::None;
+  // Post-only venues reject any order that would cross on entry.
+  static constexpr bool kPostOnly = false;
+  // Aggressive-only feeds execute everything like FillAndKill: sweep,
+  // never rest.
+  static constexpr bool kAggressiveOnly = false;
+};
+
+struct PostOnlyMatchPolicy : DefaultMatchPolicy {
+  static constexpr bool kPostOnly = true;
+};
+
+struct AggressiveOnlyMatchPolicy : DefaultMatchPolicy {
+  static constexpr bool kAggressiveOnly = true;
+};
+
+template <SelfTradePolicy policy>
+struct FixedStpMatchPolicy : DefaultMatchPolicy {
+  static constexpr bool kRuntimeSelfTradePolicy = false;
+  static constexpr SelfTradePolicy kSelfTradePolicy = policy;
+};
+
+// Empty book sides read as these uncrossable sentinels in the top-of-book
+// cache, so crossing tests compare prices without an emptiness branch.
+inline constexpr Price kNoBidPrice = std::numeric_limits<Price>::min();
+inline constexpr Price kNoAskPrice = std::numeric_limits<Price>::max();
+
+// Single-cache-line top-of-book image the book keeps current on every
+// mutation: CanMatch and strategy-side BBO polls read this one hot line
+// instead of descending a tree root per query. The sequence bumps on every
+// refresh so pollers can cheaply detect change.
+struct alignas(64) TopOfBook {
+  Price bidPrice{kNoBidPrice};
+  Price askPrice{kNoAskPrice};
+  Quantity bidQuantity{0};
+  Quantity askQuantity{0};
+  std::uint32_t sequence{0};
+};
+
+// How many levels per side get published into the shared depth snapshot.
+inline constexpr std::size_t kSnapshotDepth = 16;
+
+// Fixed-size, trivially copyable top-of-book image that the matching thread
+// publishes through a Seqlock after every mutation. Reader threads load it
+// without ever blocking the writer.
+struct DepthSnapshot {
+  std::uint32_t bidCount{0};
+  std::uint32_t askCount{0};
+  std::array<LevelInfo, kSnapshotDepth> bids{};
+  std::array<LevelInfo, kSnapshotDepth> asks{};
+};
+
+// Packed POD order record living in the pool's arena. The prev/next links
+// make every order a node of its price level's intrusive FIFO, so no list
+// nodes or control blocks get allocated per order. Side and order type share
+// one flags byte and the record is exactly 32 bytes - two orders per cache
+// line when the match loop walks a deep level.
+struct OrderNode {
+  OrderId orderId;
+  Quantity remainingQuantity;
+  Price price;
+  ParticipantId participant{kNoParticipant};
+  // Book-entry order for newest/oldest policies; 32-bit wrap is harmless
+  // because only concurrently live orders ever get compared.
+  std::uint32_t sequence{0};
+  OrderIndex prev{kNullIndex};
+  OrderIndex next{kNullIndex};
+  std::uint8_t flags{0};  // bit 0: side, bits 1-7: order type
+  std::uint8_t reserved[3]{};
+
+  static std::uint8_t MakeFlags(Side side, OrderType orderType) {
+    return static_cast<std::uint8_t>(side == Side::Sell) |
+           static_cast<std::uint8_t>(static_cast<std::uint8_t>(orderType)
+                                     << 1);
+  };
+
+  Side GetSide() const { return (flags & 1) ? Side::Sell : Side::Buy; };
+  OrderType GetOrderType() const {
+    return static_cast<OrderType>(flags >> 1);
+  };
+
+  bool isFilled() const { return remainingQuantity == 0; };
+  void Fill(Quantity quantity) {
+    if(quantity > remainingQuantity) {
+      throw std::logic_error("Order Id (" + std::to_string(orderId) +
+                             ") can't get filled more than its remaining "
+                             "quantity");
+    }
+    remainingQuantity -= quantity;
+  }
+};
+
+static_assert(sizeof(OrderNode) == 32,
+              "match-loop records are sized to pack two per cache line");
+
+// Arena of OrderNodes with a free list threaded through the `next` links.
+// Allocation only touches the heap when the arena itself has to grow.
+class OrderPool {
+ public:
+  explicit OrderPool(std::size_t capacity = 1024) { nodes_.reserve(capacity); }
+
+  OrderIndex Allocate(OrderId orderId, OrderType orderType, Quantity quantity,
+                      Price price, Side side,
+                      ParticipantId participant = kNoParticipant) {
+    OrderIndex index;
+    if(freeHead_ != kNullIndex) {
+      index = freeHead_;
+      freeHead_ = nodes_[index].next;
+    } else {
+      index = static_cast<OrderIndex>(nodes_.size());
+      nodes_.emplace_back();
+    }
+    nodes_[index] = OrderNode{orderId,    quantity,   price,
+                              participant, 0,         kNullIndex,
+                              kNullIndex, OrderNode::MakeFlags(side, orderType)};
+    return index;
+  }
+
+  void Release(OrderIndex index) {
+    nodes_[index].next = freeHead_;
+    freeHead_ = index;
+  }
+
+  OrderNode& Get(OrderIndex index) { return nodes_[index]; };
+  const OrderNode& Get(OrderIndex index) const { return nodes_[index]; };
+
+ private:
+  std::vector<OrderNode> nodes_;
+  OrderIndex freeHead_{kNullIndex};
+};
+
+// Matching engine over a pair of price ladders. The ladder type decides how
+// levels are stored and found (tree vs. dense array); everything else - order
+// storage, FIFO queues, matching - is shared. The profiler policy times the
+// instrumented operations, or (the NullProfiler default) compiles away.
+template <typename BidLadder, typename AskLadder,
+          typename Profiler = NullProfiler,
+          typename MatchPolicy = DefaultMatchPolicy>
+class BasicOrderBook {
+ private:
+  BidLadder bids_;
+  AskLadder asks_;
+  OrderIdIndex orders_;
+  OrderPool pool_;
+  Seqlock<DepthSnapshot> depth_;
+  Profiler profiler_;
+  Trades trades_;
+  TradeSink sink_;
+  DepthListener depthListener_;
+  SelfTradePolicy selfTradePolicy_{SelfTradePolicy::None};
+
+  // Resolves to the runtime setting or the policy's compile-time constant;
+  // in the fixed case the compiler folds the self-trade branches away.
+  SelfTradePolicy EffectiveSelfTradePolicy() const {
+    if constexpr(MatchPolicy::kRuntimeSelfTradePolicy)
+      return selfTradePolicy_;
+    else
+      return MatchPolicy::kSelfTradePolicy;
+  };
+  std::uint32_t sequence_{0};
+
+  // Levels touched since the last flush; existedBefore is the level's state
+  // when it was first marked, so the flush can tell added from changed.
+  struct DirtyLevel {
+    Side side;
+    Price price;
+    bool existedBefore;
+  };
+  std::vector<DirtyLevel> dirtyLevels_;
+  std::vector<Price> scratchPrices_;
+
+  // A stop order parked until the last trade reaches its trigger price;
+  // released as a market sweep (limitPrice == kMarketOrderPrice) or as a
+  // resting limit.
+  struct PendingStop {
+    OrderId orderId;
+    Quantity quantity;
+    Price limitPrice;
+    ParticipantId participant;
+  };
+  // Trigger index keyed by stop price, front bucket first to fire: buy
+  // stops fire as the price rises (lowest trigger first), sell stops as it
+  // falls. Stop flow is sparse next to order flow, so tree maps are fine
+  // here; only the front bucket is ever inspected on a price move.
+  std::map<Price, std::vector<PendingStop>> buyStops_;
+  std::map<Price, std::vector<PendingStop>, std::greater<Price>> sellStops_;
+  std::map<OrderId, std::pair<Side, Price>> stopIndex_;
+  std::vector<PendingStop> releasedStops_;
+  Price lastTradePrice_{0};
+  bool hasTraded_{false};
+
+  // Expiry-bucketed index: orders due at the same instant share one bucket,
+  // so the close expires a whole session of GoodForDay orders by draining a
+  // single bucket. Entries are lazy - an order that was filled or cancelled
+  // first is skipped at expiry by the sequence check, never searched for.
+  struct PendingExpiry {
+    OrderId orderId;
+    std::uint32_t sequence;
+  };
+  std::map<Timestamp, std::vector<PendingExpiry>> expiryBuckets_;
+  // OrderId -> (sequence, expireAt) shadow of the buckets, so the modify
+  // path can re-attach an order's expiry without scanning every bucket.
+  std::map<OrderId, std::pair<std::uint32_t, Timestamp>> expiryByOrder_;
+  Timestamp sessionEnd_{0};
+
+  void ScheduleExpiry(OrderId orderId, Timestamp expireAt) {
+    const OrderIndex* index = orders_.Find(orderId);
+    if(index == nullptr) return;  // filled on entry, nothing to expire
+    std::uint32_t sequence = pool_.Get(*index).sequence;
+    expiryBuckets_[expireAt].push_back(PendingExpiry{orderId, sequence});
+    expiryByOrder_[orderId] = {sequence, expireAt};
+  }
+
+  // The expiry (if any) still pending for the live order under this id;
+  // the sequence check rejects entries left behind by a reused id.
+  bool PendingExpiryOf(OrderId orderId, std::uint32_t sequence,
+                       Timestamp& expireAt) const {
+    auto it = expiryByOrder_.find(orderId);
+    if(it == expiryByOrder_.end() || it->second.first != sequence)
+      return false;
+    expireAt = it->second.second;
+    return true;
+  }
+  Price lastBestBid_{0};
+  Price lastBestAsk_{0};
+  bool hadBestBid_{false};
+  bool hadBestAsk_{false};
+  TopOfBook top_;
+  bool inAuction_{false};
+
+  void EmitTrade(const Trade& trade) {
+    if(sink_)
+      sink_(trade);
+    else
+      trades_.push_back(trade);
+  }
+
+  // Call before mutating the level at (side, price). Cheap no-op without a
+  // listener; with one, dedupes into a handful of entries per operation.
+  void MarkDirty(Side side, Price price) {
+    if(!depthListener_) return;
+    for(const DirtyLevel& dirty : dirtyLevels_) {
+      if(dirty.side == side && dirty.price == price) return;
+    }
+    bool exists = side == Side::Buy ? bids_.Find(price) != nullptr
+                                    : asks_.Find(price) != nullptr;
+    dirtyLevels_.push_back(DirtyLevel{side, price, exists});
+  }
+
+  void FlushDepthUpdates() {
+    if(!depthListener_) return;
+
+    for(const DirtyLevel& dirty : dirtyLevels_) {
+      Level* level = dirty.side == Side::Buy ? bids_.Find(dirty.price)
+                                             : asks_.Find(dirty.price);
+      if(level != nullptr) {
+        depthListener_(DepthUpdate{dirty.existedBefore
+                                       ? DepthUpdate::Type::LevelChanged
+                                       : DepthUpdate::Type::LevelAdded,
+                                   dirty.side, dirty.price,
+                                   level->totalQuantity});
+      } else if(dirty.existedBefore) {
+        depthListener_(DepthUpdate{DepthUpdate::Type::LevelRemoved,
+                                   dirty.side, dirty.price, 0});
+      }
+    }
+    dirtyLevels_.clear();
+
+    bool hasBestBid = !bids_.Empty();
+    Price bestBid = hasBestBid ? bids_.BestPrice() : 0;
+    if(hasBestBid != hadBestBid_ || bestBid != lastBestBid_) {
+      depthListener_(DepthUpdate{
+          DepthUpdate::Type::BestChanged, Side::Buy, bestBid,
+          hasBestBid ? bids_.BestLevel().totalQuantity : 0});
+      hadBestBid_ = hasBestBid;
+      lastBestBid_ = bestBid;
+    }
+    bool hasBestAsk = !asks_.Empty();
+    Price bestAsk = hasBestAsk ? asks_.BestPrice() : 0;
+    if(hasBestAsk != hadBestAsk_ || bestAsk != lastBestAsk_) {
+      depthListener_(DepthUpdate{
+          DepthUpdate::Type::BestChanged, Side::Sell, bestAsk,
+          hasBestAsk ? asks_.BestLevel().totalQuantity : 0});
+      hadBestAsk_ = hasBestAsk;
+      lastBestAsk_ = bestAsk;
+    }
+  }
+
+  // Refreshed at the same single choke point as the depth snapshot, after
+  // every mutating operation.
+  void UpdateTopOfBook() {
+    bool hasBid = !bids_.Empty();
+    bool hasAsk = !asks_.Empty();
+    top_.bidPrice = hasBid ? bids_.BestPrice() : kNoBidPrice;
+    top_.bidQuantity = hasBid ? bids_.BestLevel().totalQuantity : 0;
+    top_.askPrice = hasAsk ? asks_.BestPrice() : kNoAskPrice;
+    top_.askQuantity = hasAsk ? asks_.BestLevel().totalQuantity : 0;
+    ++top_.sequence;
+  }
+
+  void PublishDepth() {
+    UpdateTopOfBook();
+    DepthSnapshot snapshot;
+    bids_.ForEachLevel([&](Price price, const Level& level) {
+      snapshot.bids[snapshot.bidCount++] = LevelInfo{price,
+                                                     level.totalQuantity};
+      return snapshot.bidCount < kSnapshotDepth;
+    });
+    asks_.ForEachLevel([&](Price price, const Level& level) {
+      snapshot.asks[snapshot.askCount++] = LevelInfo{price,
+                                                     level.totalQuantity};
+      return snapshot.askCount < kSnapshotDepth;
+    });
+    depth_.Store(snapshot);
+  }
+
+  void PushBack(Level& level, OrderIndex index) {
+    OrderNode& node = pool_.Get(index);
+    node.prev = level.tail;
+    node.next = kNullIndex;
+    if(level.tail != kNullIndex)
+      pool_.Get(level.tail).next = index;
+    else
+      level.head = index;
+    level.tail = index;
+    level.totalQuantity += node.remainingQuantity;
+    ++level.orderCount;
+  }
+
+  void Unlink(Level& level, OrderIndex index) {
+    OrderNode& node = pool_.Get(index);
+    if(node.prev != kNullIndex)
+      pool_.Get(node.prev).next = node.next;
+    else
+      level.head = node.next;
+    if(node.next != kNullIndex)
+      pool_.Get(node.next).prev = node.prev;
+    else
+      level.tail = node.prev;
+    level.totalQuantity -= node.remainingQuantity;
+    --level.orderCount;
+  }
+
+  void RemoveOrder(Level& level, OrderIndex index) {
+    Unlink(level, index);
+    orders_.Erase(pool_.Get(index).orderId);
+    pool_.Release(index);
+  }
+
+  template <typename StopMap>
+  void CancelStop(StopMap& stops, OrderId orderId, Price stopPrice) {
+    auto it = stops.find(stopPrice);
+    if(it == stops.end()) return;
+    std::erase_if(it->second, [orderId](const PendingStop& stop) {
+      return stop.orderId == orderId;
+    });
+    if(it->second.empty()) stops.erase(it);
+  }
+
+  bool CanMatch(Side side, Price price) const {
+    // One load of the hot top-of-book line; empty sides are uncrossable
+    // sentinels, so there is no emptiness branch.
+    return side == Side::Buy ? price >= top_.askPrice
+                             : price <= top_.bidPrice;
+  };
+
+  // Releases every order on a level without per-order level maintenance:
+  // one orders_ erase and pool release per order, one aggregate reset.
+  void ClearLevel(Level& level) {
+    for(OrderIndex index = level.head; index != kNullIndex;) {
+      OrderIndex next = pool_.Get(index).next;
+      orders_.Erase(pool_.Get(index).orderId);
+      pool_.Release(index);
+      index = next;
+    }
+    level = Level{};
+  }
+
+  // Walks the ladder once collecting levels inside [lowPrice, highPrice],
+  // then clears them in batch. Prices are staged in a reusable scratch
+  // vector because the ladder can't be mutated mid-walk.
+  template <typename Ladder>
+  void CancelLevels(Ladder& ladder, Side side, Price lowPrice,
+                    Price highPrice) {
+    scratchPrices_.clear();
+    ladder.ForEachLevel([&](Price price, const Level&) {
+      if(price >= lowPrice && price <= highPrice)
+        scratchPrices_.push_back(price);
+      return true;
+    });
+    for(Price price : scratchPrices_) {
+      MarkDirty(side, price);
+      ClearLevel(*ladder.Find(price));
+      ladder.OnLevelEmpty(price);
+    }
+  }
+
+  // Unlinks one participant's orders from every level of a ladder; levels
+  // that empty out are dropped.
+  template <typename Ladder>
+  void CancelParticipantLevels(Ladder& ladder, Side side,
+                               ParticipantId participant) {
+    scratchPrices_.clear();
+    ladder.ForEachLevel([&](Price price, const Level&) {
+      scratchPrices_.push_back(price);
+      return true;
+    });
+    for(Price price : scratchPrices_) {
+      Level* level = ladder.Find(price);
+      bool marked = false;
+      for(OrderIndex index = level->head; index != kNullIndex;) {
+        OrderIndex next = pool_.Get(index).next;
+        if(pool_.Get(index).participant == participant) {
+          if(!marked) {
+            MarkDirty(side, price);
+            marked = true;
+          }
+          RemoveOrder(*level, index);
+        }
+        index = next;
+      }
+      if(level->empty()) ladder.OnLevelEmpty(price);
+    }
+  }
+
+  // Applies the configured policy to a would-be self-trade between the two
+  // queue heads; no trade is printed in any branch.
+  void PreventSelfTrade(Level& bids, Level& asks, OrderNode& bid,
+                        OrderNode& ask, Quantity quantity) {
+    switch(EffectiveSelfTradePolicy()) {
+      case SelfTradePolicy::CancelNewest:
+        if(bid.sequence > ask.sequence)
+          RemoveOrder(bids, bids.head);
+        else
+          RemoveOrder(asks, asks.head);
+        break;
+      case SelfTradePolicy::CancelOldest:
+        if(bid.sequence < ask.sequence)
+          RemoveOrder(bids, bids.head);
+        else
+          RemoveOrder(asks, asks.head);
+        break;
+      case SelfTradePolicy::Decrement:
+        bid.Fill(quantity);
+        ask.Fill(quantity);
+        bids.totalQuantity -= quantity;
+        asks.totalQuantity -= quantity;
+        if(bid.isFilled()) RemoveOrder(bids, bids.head);
+        if(ask.isFilled()) RemoveOrder(asks, asks.head);
+        break;
+      case SelfTradePolicy::None:
+        break;
+    }
+  }
+
+  // Reinserts a triggered stop: stop-markets sweep the opposite ladder
+  // outright, stop-limits rest at their limit and match like any entry.
+  void ReleaseStop(Side side, const PendingStop& stop) {
+    if(stop.limitPrice == kMarketOrderPrice) {
+      if(side == Side::Buy) {
+        SweepLadder(
+            asks_, [](Price) { return true; }, stop.orderId, stop.quantity,
+            kMarketOrderPrice, side, stop.participant);
+      } else {
+        SweepLadder(
+            bids_, [](Price) { return true; }, stop.orderId, stop.quantity,
+            kMarketOrderPrice, side, stop.participant);
+      }
+      return;
+    }
+
+    MarkDirty(side, stop.limitPrice);
+    OrderIndex index =
+        pool_.Allocate(stop.orderId, OrderType::GoodTillCancel, stop.quantity,
+                       stop.limitPrice, side, stop.participant);
+    pool_.Get(index).sequence = ++sequence_;
+    if(side == Side::Buy) {
+      PushBack(bids_.GetOrAdd(stop.limitPrice), index);
+    } else {
+      PushBack(asks_.GetOrAdd(stop.limitPrice), index);
+    }
+    orders_.Insert(stop.orderId, index);
+    MatchOrders();
+  }
+
+  // Consulted only after matching prints a new trade price. Each pass pops
+  // whole buckets off the front of a side's trigger map, so a price move
+  // costs O(triggered) no matter how many stops are parked; releases that
+  // trade and move the price again cascade through the loop.
+  void TriggerStops() {
+    // Nothing executes during an auction call: stops entered or passed
+    // while it lasts stay parked, and Uncross re-evaluates them against
+    // the auction print once continuous matching resumes.
+    if(!hasTraded_ || inAuction_) return;
+    while(true) {
+      Side side;
+      if(!buyStops_.empty() && buyStops_.begin()->first <= lastTradePrice_) {
+        side = Side::Buy;
+        auto it = buyStops_.begin();
+        releasedStops_.swap(it->second);
+        buyStops_.erase(it);
+      } else if(!sellStops_.empty() &&
+                sellStops_.begin()->first >= lastTradePrice_) {
+        side = Side::Sell;
+        auto it = sellStops_.begin();
+        releasedStops_.swap(it->second);
+        sellStops_.erase(it);
+      } else {
+        break;
+      }
+      for(const PendingStop& stop : releasedStops_) {
+        stopIndex_.erase(stop.orderId);
+        ReleaseStop(side, stop);
+      }
+      releasedStops_.clear();
+    }
+  }
+
+  const Trades& QueueStop(OrderId orderId, Quantity quantity, Price stopPrice,
+                          Price limitPrice, Side side,
+                          ParticipantId participant) {
+    // The limit price rests on the ladder once the stop fires; reject one
+    // off a dense ladder's grid at entry rather than mid-trigger cascade.
+    if(limitPrice != kMarketOrderPrice) {
+      if(side == Side::Buy) {
+        bids_.ValidatePrice(limitPrice);
+      } else {
+        asks_.ValidatePrice(limitPrice);
+      }
+    }
+
+    trades_.clear();
+    if(side == Side::Buy) {
+      buyStops_[stopPrice].push_back(
+          PendingStop{orderId, quantity, limitPrice, participant});
+    } else {
+      sellStops_[stopPrice].push_back(
+          PendingStop{orderId, quantity, limitPrice, participant});
+    }
+    stopIndex_.emplace(orderId, std::pair{side, stopPrice});
+    // A stop entered at or past its trigger fires off the last trade.
+    TriggerStops();
+    PublishDepth();
+    FlushDepthUpdates();
+    return trades_;
+  }
+
+  // Fills go to the sink when one is installed, otherwise into the reusable
+  // trades_ buffer, which keeps its capacity across calls so steady-state
+  // matching never allocates.
+  // Appends into trades_ (the public entry points clear it), so a cascade
+  // of stop releases accumulates its fills into one report.
+  const Trades& MatchOrders() {
+    typename Profiler::Scope scope{profiler_, BookOp::Match};
+    while(true) {
+      if(asks_.Empty() || bids_.Empty()) break;
+
+      Price bidPrice = bids_.BestPrice();
+      Price askPrice = asks_.BestPrice();
+
+      if(bidPrice < askPrice) break;
+
+      MarkDirty(Side::Buy, bidPrice);
+      MarkDirty(Side::Sell, askPrice);
+      lastTradePrice_ = askPrice;
+      hasTraded_ = true;
+
+      Level& bids = bids_.BestLevel();
+      Level& asks = asks_.BestLevel();
+
+      while(!bids.empty() && !asks.empty()) {
+        OrderNode& bid = pool_.Get(bids.head);
+        OrderNode& ask = pool_.Get(asks.head);
+        Quantity quantity =
+            std::min(bid.remainingQuantity, ask.remainingQuantity);
+
+        if(EffectiveSelfTradePolicy() != SelfTradePolicy::None &&
+           bid.participant == ask.participant &&
+           bid.participant != kNoParticipant) {
+          PreventSelfTrade(bids, asks, bid, ask, quantity);
+          continue;
+        }
+
+        bid.Fill(quantity);
+        ask.Fill(quantity);
+        bids.totalQuantity -= quantity;
+        asks.totalQuantity -= quantity;
+
+        EmitTrade(
+            Trade{TradeInfos{bid.orderId, bid.price, quantity,
+                             bid.participant},
+                  TradeInfos{ask.orderId, ask.price, quantity,
+                             ask.participant}});
+
+        if(bid.isFilled()) RemoveOrder(bids, bids.head);
+        if(ask.isFilled()) RemoveOrder(asks, asks.head);
+      }
+      if(bids.empty()) bids_.OnLevelEmpty(bidPrice);
+      if(asks.empty()) asks_.OnLevelEmpty(askPrice);
+    }
+
+    return trades_;
+  }
+
+  // FillAndKill execution: walk the opposite ladder from the touch and fill
+  // against resting orders until the limit stops crossing or the aggressor
+  // is done; whatever is left is killed. The aggressor never touches the
+  // ladder, the FIFO or the orders_ index. Returns the unfilled remainder.
+  template <typename Ladder, typename Crosses>
+  Quantity SweepLadder(Ladder& ladder, Crosses&& crosses, OrderId orderId,
+                       Quantity remaining, Price limitPrice, Side side,
+                       ParticipantId participant) {
+    while(remaining > 0 && !ladder.Empty()) {
+      Price bestPrice = ladder.BestPrice();
+      if(!crosses(bestPrice)) break;
+
+      MarkDirty(side == Side::Buy ? Side::Sell : Side::Buy, bestPrice);
+      lastTradePrice_ = bestPrice;
+      hasTraded_ = true;
+      Level& level = ladder.BestLevel();
+      while(!level.empty() && remaining > 0) {
+        OrderNode& resting = pool_.Get(level.head);
+        Quantity quantity = std::min(remaining, resting.remainingQuantity);
+
+        if(EffectiveSelfTradePolicy() != SelfTradePolicy::None &&
+           resting.participant == participant &&
+           participant != kNoParticipant) {
+          // The aggressor is by definition the newest order.
+          if(EffectiveSelfTradePolicy() == SelfTradePolicy::CancelNewest) {
+            remaining = 0;
+            break;
+          }
+          if(EffectiveSelfTradePolicy() == SelfTradePolicy::CancelOldest) {
+            RemoveOrder(level, level.head);
+          } else {  // Decrement
+            resting.Fill(quantity);
+            level.totalQuantity -= quantity;
+            remaining -= quantity;
+            if(resting.isFilled()) RemoveOrder(level, level.head);
+          }
+          continue;
+        }
+
+        resting.Fill(quantity);
+        level.totalQuantity -= quantity;
+        remaining -= quantity;
+        Price tradePrice =
+            limitPrice == kMarketOrderPrice ? resting.price : limitPrice;
+        if(side == Side::Buy) {
+          EmitTrade(Trade{TradeInfos{orderId, tradePrice, quantity,
+                                     participant},
+                          TradeInfos{resting.orderId, resting.price, quantity,
+                                     resting.participant}});
+        } else {
+          EmitTrade(Trade{TradeInfos{resting.orderId, resting.price, quantity,
+                                     resting.participant},
+                          TradeInfos{orderId, tradePrice, quantity,
+                                     participant}});
+        }
+        if(resting.isFilled()) RemoveOrder(level, level.head);
+      }
+      if(level.empty()) ladder.OnLevelEmpty(bestPrice);
+    }
+    return remaining;
+  }
+
+ public:
+  BasicOrderBook() = default;
+
+  // Ladder configuration, e.g. the dense ladder's price range and tick.
+  template <typename... Args>
+  explicit BasicOrderBook(Args... args)
+      : bids_{args...}, asks_{args...} {}
+
+  // The returned buffer is owned by the book and stays valid until the next
+  // mutating call.
+  const Trades& AddOrder(OrderId orderId, OrderType orderType,
+                         Quantity quantity, Price price, Side side,
+                         ParticipantId participant = kNoParticipant) {
+    typename Profiler::Scope scope{profiler_, BookOp::AddOrder};
+    if(orders_.Contains(orderId) || stopIndex_.contains(orderId)) {
+      trades_.clear();
+      return trades_;
+    }
+
+    if constexpr(MatchPolicy::kPostOnly) {
+      // A post-only venue carries no taking flow at all: market orders and
+      // stops (which release as takers) are rejected outright, as is any
+      // limit that would cross on entry.
+      if(orderType == OrderType::Market || orderType == OrderType::Stop ||
+         orderType == OrderType::StopLimit || CanMatch(side, price)) {
+        trades_.clear();
+        return trades_;
+      }
+    }
+
+    // During an auction call nothing executes, so sweeping order types
+    // have no meaning and are rejected outright; everything else just
+    // accumulates until Uncross.
+    if(inAuction_ && (orderType == OrderType::FillAndKill ||
+                      orderType == OrderType::Market ||
+                      MatchPolicy::kAggressiveOnly)) {
+      trades_.clear();
+      return trades_;
+    }
+
+    // Stop entries park in the trigger index; `price` is the trigger. A
+    // bare Stop releases as a market order; a StopLimit entered through this
+    // overload limits at its trigger price (use AddStopLimitOrder for a
+    // distinct limit).
+    if(orderType == OrderType::Stop || orderType == OrderType::StopLimit) {
+      return QueueStop(
+          orderId, quantity, price,
+          orderType == OrderType::Stop ? kMarketOrderPrice : price, side,
+          participant);
+    }
+
+    if(orderType == OrderType::GoodForDay && sessionEnd_ == 0) {
+      throw std::logic_error("GoodForDay order before SetSessionEnd");
+    }
+
+    if(orderType == OrderType::Market) {
+      trades_.clear();
+      if(side == Side::Buy) {
+        SweepLadder(
+            asks_, [](Price) { return true; }, orderId, quantity,
+            kMarketOrderPrice, side, participant);
+      } else {
+        SweepLadder(
+            bids_, [](Price) { return true; }, orderId, quantity,
+            kMarketOrderPrice, side, participant);
+      }
+      TriggerStops();
+      PublishDepth();
+      FlushDepthUpdates();
+      return trades_;
+    }
+
+    if(orderType == OrderType::FillAndKill ||
+       MatchPolicy::kAggressiveOnly) {
+      trades_.clear();
+      if(!CanMatch(side, price)) return trades_;
+      if(side == Side::Buy) {
+        SweepLadder(
+            asks_, [price](Price best) { return price >= best; }, orderId,
+            quantity, price, side, participant);
+      } else {
+        SweepLadder(
+            bids_, [price](Price best) { return price <= best; }, orderId,
+            quantity, price, side, participant);
+      }
+      TriggerStops();
+      PublishDepth();
+      FlushDepthUpdates();
+      return trades_;
+    }
+
+    // Pre-flight the resting price before anything is committed: a dense
+    // ladder throws on an off-grid price, and doing that after MarkDirty or
+    // pool_.Allocate would leave a phantom dirty level or leak an arena slot.
+    if(side == Side::Buy) {
+      bids_.ValidatePrice(price);
+    } else {
+      asks_.ValidatePrice(price);
+    }
+
+    trades_.clear();
+    MarkDirty(side, price);
+    OrderIndex index = pool_.Allocate(orderId, orderType, quantity, price,
+                                      side, participant);
+    pool_.Get(index).sequence = ++sequence_;
+
+    if(side == Side::Buy) {
+      PushBack(bids_.GetOrAdd(price), index);
+    } else {
+      PushBack(asks_.GetOrAdd(price), index);
+    }
+
+    orders_.Insert(orderId, index);
+
+    if(!inAuction_) {
+      MatchOrders();
+      TriggerStops();
+    }
+    if(orderType == OrderType::GoodForDay) ScheduleExpiry(orderId, sessionEnd_);
+    PublishDepth();
+    FlushDepthUpdates();
+    return trades_;
+  }
+
+  // Good-till-time: a GoodTillCancel order that ExpireOrders cancels once
+  // the session clock reaches `expireAt`.
+  const Trades& AddGoodTillTime(OrderId orderId, Quantity quantity,
+                                Price price, Side side, Timestamp expireAt,
+                                ParticipantId participant = kNoParticipant) {
+    // Reject duplicates here rather than trusting the inner AddOrder to:
+    // scheduling after a rejected add would find the pre-existing order
+    // under this id and expire it instead.
+    if(orders_.Contains(orderId) || stopIndex_.contains(orderId)) {
+      trades_.clear();
+      return trades_;
+    }
+    const Trades& trades = AddOrder(orderId, OrderType::GoodTillCancel,
+                                    quantity, price, side, participant);
+    ScheduleExpiry(orderId, expireAt);
+    return trades;
+  }
+
+  // Stop-limit with a limit price distinct from the trigger: rests at
+  // `limitPrice` once the last trade reaches `stopPrice`.
+  const Trades& AddStopLimitOrder(OrderId orderId, Quantity quantity,
+                                  Price stopPrice, Price limitPrice, Side side,
+                                  ParticipantId participant = kNoParticipant) {
+    typename Profiler::Scope scope{profiler_, BookOp::AddOrder};
+    if(orders_.Contains(orderId) || stopIndex_.contains(orderId)) {
+      trades_.clear();
+      return trades_;
+    }
+    if constexpr(MatchPolicy::kPostOnly) {
+      trades_.clear();
+      return trades_;  // stops release as takers; a post-only venue has none
+    }
+    return QueueStop(orderId, quantity, stopPrice, limitPrice, side,
+                     participant);
+  }
+
+  const Trades& AddOrder(OrderPointer order) {
+    return AddOrder(order->GetOrderId(), order->GetOrderType(),
+                    order->GetRemainingQuantity(), order->GetPrice(),
+                    order->GetSide());
+  }
+
+  void CancelOrder(OrderId orderId) {
+    typename Profiler::Scope scope{profiler_, BookOp::CancelOrder};
+    if(!orders_.Contains(orderId)) {
+      auto stopIt = stopIndex_.find(orderId);
+      if(stopIt == stopIndex_.end()) return;
+      if(stopIt->second.first == Side::Buy)
+        CancelStop(buyStops_, orderId, stopIt->second.second);
+      else
+        CancelStop(sellStops_, orderId, stopIt->second.second);
+      stopIndex_.erase(stopIt);
+      return;
+    }
+
+    OrderIndex index = *orders_.Find(orderId);
+    const OrderNode& order = pool_.Get(index);
+    MarkDirty(order.GetSide(), order.price);
+
+    if(order.GetSide() == Side::Buy) {
+      Level* level = bids_.Find(order.price);
+      RemoveOrder(*level, index);
+      if(level->empty()) bids_.OnLevelEmpty(order.price);
+    } else {
+      Level* level = asks_.Find(order.price);
+      RemoveOrder(*level, index);
+      if(level->empty()) asks_.OnLevelEmpty(order.price);
+    }
+
+    PublishDepth();
+    FlushDepthUpdates();
+  }
+
+  const Trades& ModifyOrder(OrderModify order) {
+    if(!orders_.Contains(order.GetOrderId())) {
+      trades_.clear();
+      return trades_;
+    }
+
+    OrderIndex index = *orders_.Find(order.GetOrderId());
+    OrderNode& node = pool_.Get(index);
+
+    // Quantity-down at the same price keeps time priority and can't cross,
+    // so edit the node and its level aggregate in place - no cancel,
+    // reinsert or matching pass.
+    if(order.GetOrderPrice() == node.price &&
+       order.GetOrderSide() == node.GetSide() &&
+       order.GetOrderQuantity() < node.remainingQuantity &&
+       order.GetOrderQuantity() > 0) {
+      MarkDirty(node.GetSide(), node.price);
+      Level* level = node.GetSide() == Side::Buy ? bids_.Find(node.price)
+                                                 : asks_.Find(node.price);
+      level->totalQuantity -= node.remainingQuantity - order.GetOrderQuantity();
+      node.remainingQuantity = order.GetOrderQuantity();
+      PublishDepth();
+      FlushDepthUpdates();
+      trades_.clear();
+      return trades_;
+    }
+
+    // Capture what the re-add must preserve before CancelOrder releases the
+    // node: the participant id keeps STP, CancelByParticipant and fill
+    // attribution working across the amendment, and a pending good-till-time
+    // expiry must follow the order's fresh sequence or the bucket entry is
+    // orphaned and the order silently becomes GoodTillCancel.
+    OrderType orderType = node.GetOrderType();
+    ParticipantId participant = node.participant;
+    Timestamp expireAt = 0;
+    bool hadExpiry = PendingExpiryOf(order.GetOrderId(), node.sequence,
+                                     expireAt);
+    CancelOrder(order.GetOrderId());
+    const Trades& trades =
+        AddOrder(order.GetOrderId(), orderType, order.GetOrderQuantity(),
+                 order.GetOrderPrice(), order.GetOrderSide(), participant);
+    // GoodForDay re-adds reschedule themselves inside AddOrder.
+    if(hadExpiry && orderType != OrderType::GoodForDay) {
+      ScheduleExpiry(order.GetOrderId(), expireAt);
+    }
+    return trades;
+  }
+
+  // Copies the precomputed per-level totals; pass `depth` to get only the
+  // best N levels per side.
+  OrderBookLevelInfos GetLevelInfos(
+      std::size_t depth = std::numeric_limits<std::size_t>::max()) const {
+    LevelInfos bidsInfos, asksInfos;
+    bidsInfos.reserve(std::min(depth, bids_.LevelCount()));
+    asksInfos.reserve(std::min(depth, asks_.LevelCount()));
+
+    bids_.ForEachLevel([&](Price price, const Level& level) {
+      bidsInfos.push_back(LevelInfo{price, level.totalQuantity});
+      return bidsInfos.size() < depth;
+    });
+
+    asks_.ForEachLevel([&](Price price, const Level& level) {
+      asksInfos.push_back(LevelInfo{price, level.totalQuantity});
+      return asksInfos.size() < depth;
+    });
+
+    return OrderBookLevelInfos{bidsInfos, asksInfos};
+  }
+
+  // Mass-quote pull: bulk cancellation walks each ladder once and releases
+  // orders level-by-level, amortizing the index/ladder maintenance that
+  // per-order CancelOrder calls would repeat.
+  void CancelAll() {
+    CancelLevels(bids_, Side::Buy, std::numeric_limits<Price>::min(),
+                 std::numeric_limits<Price>::max());
+    CancelLevels(asks_, Side::Sell, std::numeric_limits<Price>::min(),
+                 std::numeric_limits<Price>::max());
+    PublishDepth();
+    FlushDepthUpdates();
+  }
+
+  void CancelAllBySide(Side side) {
+    CancelOrdersInRange(side, std::numeric_limits<Price>::min(),
+                        std::numeric_limits<Price>::max());
+  }
+
+  void CancelOrdersInRange(Side side, Price lowPrice, Price highPrice) {
+    if(side == Side::Buy)
+      CancelLevels(bids_, side, lowPrice, highPrice);
+    else
+      CancelLevels(asks_, side, lowPrice, highPrice);
+    PublishDepth();
+    FlushDepthUpdates();
+  }
+
+  void CancelByParticipant(ParticipantId participant) {
+    CancelParticipantLevels(bids_, Side::Buy, participant);
+    CancelParticipantLevels(asks_, Side::Sell, participant);
+    PublishDepth();
+    FlushDepthUpdates();
+  }
+
+  // Visits every resting order, best level first and in FIFO order within a
+  // level (bids then asks) - the order a snapshot must restore them in to
+  // preserve time priority.
+  template <typename F>
+  void ForEachOrder(F&& f) const {
+    auto walkLevel = [&](Price, const Level& level) {
+      for(OrderIndex index = level.head; index != kNullIndex;
+          index = pool_.Get(index).next) {
+        f(pool_.Get(index));
+      }
+      return true;
+    };
+    bids_.ForEachLevel(walkLevel);
+    asks_.ForEachLevel(walkLevel);
+  }
+
+  // Stops waiting in the trigger index; they are not open book orders.
+  std::size_t PendingStopCount() const { return stopIndex_.size(); };
+
+  // Visits every parked stop as (orderId, quantity, stopPrice, limitPrice,
+  // side, participant), buy side first, trigger order within a side and
+  // FIFO within a bucket - the order a snapshot must restore them in to
+  // keep same-trigger priority. limitPrice is kMarketOrderPrice for a bare
+  // stop.
+  template <typename F>
+  void ForEachPendingStop(F&& f) const {
+    for(const auto& [stopPrice, bucket] : buyStops_) {
+      for(const PendingStop& stop : bucket) {
+        f(stop.orderId, stop.quantity, stopPrice, stop.limitPrice, Side::Buy,
+          stop.participant);
+      }
+    }
+    for(const auto& [stopPrice, bucket] : sellStops_) {
+      for(const PendingStop& stop : bucket) {
+        f(stop.orderId, stop.quantity, stopPrice, stop.limitPrice, Side::Sell,
+          stop.participant);
+      }
+    }
+  }
+
+  // Visits each resting order's pending expiry (if it has one) as
+  // (orderId, expireAt). Walks the per-order shadow, not the buckets, so a
+  // rescheduled order is reported once with its latest expiry and stale
+  // bucket entries never surface.
+  template <typename F>
+  void ForEachPendingExpiry(F&& f) const {
+    for(const auto& [orderId, entry] : expiryByOrder_) {
+      const OrderIndex* index = orders_.Find(orderId);
+      if(index == nullptr || pool_.Get(*index).sequence != entry.first)
+        continue;
+      f(orderId, entry.second);
+    }
+  }
+
+  // Attaches (or refreshes) an expiry on an already-resting order; recovery
+  // uses this to re-arm good-till-time orders restored from a snapshot.
+  // Unknown ids are ignored.
+  void ScheduleExpiryFor(OrderId orderId, Timestamp expireAt) {
+    ScheduleExpiry(orderId, expireAt);
+  }
+
+  std::size_t OpenOrderCount() const { return orders_.Size(); };
+
+  // Wait-free consistent depth for reader threads; safe to call concurrently
+  // with the (single) matching thread mutating the book.
+  // Branchless BBO reads off the hot cache line; empty sides come back as
+  // kNoBidPrice/kNoAskPrice with zero quantity.
+  const TopOfBook& Top() const { return top_; };
+  Price BestBidPrice() const { return top_.bidPrice; };
+  Price BestAskPrice() const { return top_.askPrice; };
+  Quantity BestBidQuantity() const { return top_.bidQuantity; };
+  Quantity BestAskQuantity() const { return top_.askQuantity; };
+
+  DepthSnapshot LoadDepthSnapshot() const { return depth_.Load(); }
+
+  // For histogram export when the profiler policy records anything.
+  const Profiler& GetProfiler() const { return profiler_; }
+
+  void SetTradeSink(TradeSink sink) { sink_ = std::move(sink); }
+
+  void SetDepthListener(DepthListener listener) {
+    depthListener_ = std::move(listener);
+  }
+
+  // Call-auction mode for the open/close: between EnterAuction and Uncross
+  // the book accumulates orders without continuous matching, so it may sit
+  // crossed the whole call.
+  void EnterAuction() { inAuction_ = true; };
+  bool InAuction() const { return inAuction_; };
+
+  // Uncrosses the call: finds the equilibrium price - the one maximizing
+  // executable volume over the cumulative bid/ask curves, ties broken by
+  // smallest imbalance and then proximity to the last trade - crosses
+  // everything marketable at that single price in price-time priority, and
+  // returns to continuous matching. The curves are gathered into contiguous
+  // arrays covering just the crossed region, so the scan over thousands of
+  // levels is two tight passes over flat memory.
+  const Trades& Uncross() {
+    trades_.clear();
+    inAuction_ = false;
+    if(bids_.Empty() || asks_.Empty() ||
+       bids_.BestPrice() < asks_.BestPrice()) {
+      // Nothing crossed; still evaluate stops parked during the call
+      // against the pre-auction last trade before continuous flow resumes.
+      TriggerStops();
+      PublishDepth();
+      FlushDepthUpdates();
+      return trades_;
+    }
+
+    Price bestBid = bids_.BestPrice();
+    Price bestAsk = asks_.BestPrice();
+
+    // Cumulative volume curves over the crossed region, bids best-first
+    // (descending price), asks best-first (ascending).
+    std::vector<Price> bidPrices, askPrices;
+    std::vector<std::int64_t> bidVolumes, askVolumes;
+    std::int64_t running = 0;
+    bids_.ForEachLevel([&](Price price, const Level& level) {
+      if(price < bestAsk) return false;
+      running += level.totalQuantity;
+      bidPrices.push_back(price);
+      bidVolumes.push_back(running);
+      return true;
+    });
+    running = 0;
+    asks_.ForEachLevel([&](Price price, const Level& level) {
+      if(price > bestBid) return false;
+      running += level.totalQuantity;
+      askPrices.push_back(price);
+      askVolumes.push_back(running);
+      return true;
+    });
+
+    // Walk the candidate prices ascending with two cursors into the curves:
+    // bids at or above the candidate, asks at or below it.
+    Price equilibrium = bestAsk;
+    std::int64_t bestVolume = -1, bestImbalance = 0;
+    std::size_t bidAt = bidPrices.size();
+    std::size_t askAt = 0;
+    auto consider = [&](Price candidate) {
+      while(bidAt > 0 && bidPrices[bidAt - 1] < candidate) --bidAt;
+      while(askAt < askPrices.size() && askPrices[askAt] <= candidate)
+        ++askAt;
+      std::int64_t bidVolume = bidAt > 0 ? bidVolumes[bidAt - 1] : 0;
+      std::int64_t askVolume = askAt > 0 ? askVolumes[askAt - 1] : 0;
+      std::int64_t volume = std::min(bidVolume, askVolume);
+      std::int64_t imbalance = std::abs(bidVolume - askVolume);
+      bool better =
+          volume > bestVolume ||
+          (volume == bestVolume &&
+           (imbalance < bestImbalance ||
+            (imbalance == bestImbalance &&
+             std::abs(candidate - lastTradePrice_) <
+                 std::abs(equilibrium - lastTradePrice_))));
+      if(better) {
+        equilibrium = candidate;
+        bestVolume = volume;
+        bestImbalance = imbalance;
+      }
+    };
+    // Merge the two sorted price lists ascending without materializing the
+    // union; evaluating a price twice is harmless (same result, not better).
+    {
+      std::size_t b = bidPrices.size(), a = 0;
+      while(b > 0 || a < askPrices.size()) {
+        if(a >= askPrices.size() ||
+           (b > 0 && bidPrices[b - 1] <= askPrices[a])) {
+          consider(bidPrices[--b]);
+        } else {
+          consider(askPrices[a++]);
+        }
+      }
+    }
+
+    // Cross everything marketable at the equilibrium, best levels first so
+    // price-time priority holds; every print is at the single clearing
+    // price. The long side's leftovers rest; by maximality of the
+    // equilibrium volume they cannot still cross the remaining book.
+    while(!bids_.Empty() && !asks_.Empty()) {
+      Price bidPrice = bids_.BestPrice();
+      Price askPrice = asks_.BestPrice();
+      if(bidPrice < equilibrium || askPrice > equilibrium) break;
+
+      MarkDirty(Side::Buy, bidPrice);
+      MarkDirty(Side::Sell, askPrice);
+      lastTradePrice_ = equilibrium;
+      hasTraded_ = true;
+
+      Level& bids = bids_.BestLevel();
+      Level& asks = asks_.BestLevel();
+      while(!bids.empty() && !asks.empty()) {
+        OrderNode& bid = pool_.Get(bids.head);
+        OrderNode& ask = pool_.Get(asks.head);
+        Quantity quantity =
+            std::min(bid.remainingQuantity, ask.remainingQuantity);
+
+        bid.Fill(quantity);
+        ask.Fill(quantity);
+        bids.totalQuantity -= quantity;
+        asks.totalQuantity -= quantity;
+
+        EmitTrade(Trade{TradeInfos{bid.orderId, equilibrium, quantity,
+                                   bid.participant},
+                        TradeInfos{ask.orderId, equilibrium, quantity,
+                                   ask.participant}});
+
+        if(bid.isFilled()) RemoveOrder(bids, bids.head);
+        if(ask.isFilled()) RemoveOrder(asks, asks.head);
+      }
+      if(bids.empty()) bids_.OnLevelEmpty(bidPrice);
+      if(asks.empty()) asks_.OnLevelEmpty(askPrice);
+    }
+
+    // Back to continuous: a defensive match pass (a no-op on an uncrossed
+    // book), then stops triggered by the auction print.
+    MatchOrders();
+    TriggerStops();
+    PublishDepth();
+    FlushDepthUpdates();
+    return trades_;
+  }
+
+  // When GoodForDay orders expire; must be set before the first one arrives.
+  void SetSessionEnd(Timestamp sessionEnd) { sessionEnd_ = sessionEnd; };
+
+  // Clock tick from the owning thread: cancels every order whose expiry is
+  // at or before `now` by draining whole buckets, with one depth publish at
+  // the end like the bulk cancels. Returns how many orders were expired.
+  std::size_t ExpireOrders(Timestamp now) {
+    std::size_t expired = 0;
+    while(!expiryBuckets_.empty() && expiryBuckets_.begin()->first <= now) {
+      auto it = expiryBuckets_.begin();
+      for(const PendingExpiry& entry : it->second) {
+        // The bucket entry is consumed either way; drop its shadow unless a
+        // newer schedule for the same id has replaced it.
+        auto shadowIt = expiryByOrder_.find(entry.orderId);
+        if(shadowIt != expiryByOrder_.end() &&
+           shadowIt->second.first == entry.sequence) {
+          expiryByOrder_.erase(shadowIt);
+        }
+
+        const OrderIndex* found = orders_.Find(entry.orderId);
+        if(found == nullptr) continue;
+        OrderIndex index = *found;
+        const OrderNode& order = pool_.Get(index);
+        // A reused order id is a different order; the sequence tells.
+        if(order.sequence != entry.sequence) continue;
+
+        Side side = order.GetSide();
+        Price price = order.price;
+        MarkDirty(side, price);
+        if(side == Side::Buy) {
+          Level* level = bids_.Find(price);
+          RemoveOrder(*level, index);
+          if(level->empty()) bids_.OnLevelEmpty(price);
+        } else {
+          Level* level = asks_.Find(price);
+          RemoveOrder(*level, index);
+          if(level->empty()) asks_.OnLevelEmpty(price);
+        }
+        ++expired;
+      }
+      expiryBuckets_.erase(it);
+    }
+    if(expired > 0) {
+      PublishDepth();
+      FlushDepthUpdates();
+    }
+    return expired;
+  }
+
+  void SetSelfTradePolicy(SelfTradePolicy policy) {
+    static_assert(MatchPolicy::kRuntimeSelfTradePolicy,
+                  "this book's self-trade policy is fixed at compile time");
+    selfTradePolicy_ = policy;
+  }
+};
+
+// The general-purpose book: unbounded price range, tree-backed ladders.
+using OrderBook = BasicOrderBook<MapLadder<std::greater<Price>>,
+                                 MapLadder<std::less<Price>>>;
+
+// Bounded-tick-range book: O(1) best-of-book, allocation-free level
+// insertion. Construct with (minPrice, maxPrice, tick).
+using DenseOrderBook =
+    BasicOrderBook<DenseLadder<Side::Buy>, DenseLadder<Side::Sell>>;
+
+// OrderBook with rdtsc latency histograms around add/cancel/match; a
+// background thread can snapshot them via GetProfiler().Load(op).
+using ProfiledOrderBook =
+    BasicOrderBook<MapLadder<std::greater<Price>>, MapLadder<std::less<Price>>,
+                   TscProfiler>;
+
+// Post-only venue: orders that would cross on entry are rejected, so the
+// compiled match loop only ever runs on resting flow.
+using PostOnlyOrderBook =
+    BasicOrderBook<MapLadder<std::greater<Price>>, MapLadder<std::less<Price>>,
+                   NullProfiler, PostOnlyMatchPolicy>;
+
+// Aggressive-only feed: every order sweeps like FillAndKill and nothing
+// rests.
+using AggressiveOnlyOrderBook =
+    BasicOrderBook<MapLadder<std::greater<Price>>, MapLadder<std::less<Price>>,
+                   NullProfiler, AggressiveOnlyMatchPolicy>;
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef RISK_H
+#define RISK_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "broadcast_ring.hpp"
+#include "fanout.hpp"
+#include "ingress.hpp"
+#include "order_index.hpp"
+#include "orderbook.hpp"
+
+// Pre-trade risk stage sitting between the ingress ring and AddOrder: the
+// gateway thread runs every command through Check/Submit and violating
+// commands are rejected before they ever reach the book, so the match loop
+// carries no risk branches at all. Per-participant limits and counters live
+// in flat arrays indexed by participant id - a check is a couple of array
+// loads. Positions and fill-driven open-order decrements come off the trade
+// fan-out stream (PollEvents), not the match path.
+
+struct RiskLimits {
+  Quantity maxOrderSize{std::numeric_limits<Quantity>::max()};
+  std::int64_t maxOrderNotional{std::numeric_limits<std::int64_t>::max()};
+  std::uint32_t maxOpenOrders{std::numeric_limits<std::uint32_t>::max()};
+};
+
+enum class RiskVerdict : std::uint8_t {
+  Accept,
+  UnknownParticipant,  // id outside the configured participant range
+  OrderTooLarge,
+  NotionalTooLarge,
+  TooManyOpenOrders,
+};
+
+template <typename Book>
+class RiskGate {
+ public:
+  explicit RiskGate(Book& book, std::size_t maxParticipants = 256)
+      : book_{&book},
+        limits_(maxParticipants),
+        counters_(maxParticipants) {}
+
+  void SetLimits(ParticipantId participant, const RiskLimits& limits) {
+    limits_[static_cast<std::size_t>(participant)] = limits;
+  }
+
+  // Gateway thread: checks the command and forwards it into the book only
+  // on Accept. Cancels and modifies always pass risk - taking flow off the
+  // book can't add exposure.
+  RiskVerdict Submit(const OrderCommand& command, ParticipantId participant) {
+    if(participant < 0 ||
+       static_cast<std::size_t>(participant) >= limits_.size()) {
+      return RiskVerdict::UnknownParticipant;
+    }
+
+    switch(command.type) {
+      case OrderCommand::Type::NewOrder: {
+        RiskVerdict verdict = CheckNewOrder(command, participant);
+        if(verdict != RiskVerdict::Accept) return verdict;
+        book_->AddOrder(command.orderId, command.orderType, command.quantity,
+                        command.price, command.side, participant);
+        // Only orders that can rest count against the open-order limit;
+        // sweeps (FillAndKill, Market) are gone by the time AddOrder
+        // returns, and parked stops are not yet exposure on the book. An
+        // order that fills on entry is retired by its own fill events.
+        if((command.orderType == OrderType::GoodTillCancel ||
+            command.orderType == OrderType::GoodForDay) &&
+           !orderOwner_.Contains(command.orderId)) {
+          orderOwner_.Insert(command.orderId,
+                             static_cast<OrderIndex>(participant));
+          restingQuantity_.Insert(command.orderId,
+                                  static_cast<OrderIndex>(command.quantity));
+          ++counters_[static_cast<std::size_t>(participant)].openOrders;
+        }
+        return RiskVerdict::Accept;
+      }
+      case OrderCommand::Type::Cancel: {
+        book_->CancelOrder(command.orderId);
+        Retire(command.orderId);
+        return RiskVerdict::Accept;
+      }
+      case OrderCommand::Type::Modify: {
+        RiskVerdict verdict = CheckNewOrder(command, participant);
+        if(verdict != RiskVerdict::Accept) return verdict;
+        book_->ModifyOrder(OrderModify{command.orderId, command.side,
+                                       command.quantity, command.price});
+        if(OrderIndex* remaining = restingQuantity_.Find(command.orderId)) {
+          *remaining = static_cast<OrderIndex>(command.quantity);
+        }
+        return RiskVerdict::Accept;
+      }
+    }
+    return RiskVerdict::Accept;
+  }
+
+  // Gateway thread, between submits: pumps the fan-out stream to update
+  // positions and retire filled orders. A gap means fills were missed and
+  // positions are stale until reconciled; surfaced via the return value of
+  // the reader, counters keep going on whatever does arrive.
+  std::size_t PollEvents(BroadcastReader<BookEvent>& reader,
+                         std::size_t maxBatch = 256) {
+    BookEvent event;
+    std::size_t handled = 0;
+    while(handled < maxBatch &&
+          reader.TryPoll(event) == BroadcastReader<BookEvent>::Poll::Item) {
+      OnEvent(event);
+      ++handled;
+    }
+    return handled;
+  }
+
+  void OnEvent(const BookEvent& event) {
+    if(event.kind != BookEvent::Kind::Trade) return;
+    Credit(event.bidTrade.participant, event.bidTrade.quantity);
+    Credit(event.askTrade.participant, -event.askTrade.quantity);
+    Decrement(event.bidTrade.orderId, event.bidTrade.quantity);
+    Decrement(event.askTrade.orderId, event.askTrade.quantity);
+  }
+
+  std::int64_t Position(ParticipantId participant) const {
+    return counters_[static_cast<std::size_t>(participant)].position;
+  };
+
+  std::uint32_t OpenOrders(ParticipantId participant) const {
+    return counters_[static_cast<std::size_t>(participant)].openOrders;
+  };
+
+ private:
+  struct Counters {
+    std::int64_t position{0};
+    std::uint32_t openOrders{0};
+  };
+
+  RiskVerdict CheckNewOrder(const OrderCommand& command,
+                            ParticipantId participant) const {
+    const RiskLimits& limits = limits_[static_cast<std::size_t>(participant)];
+    if(command.quantity > limits.maxOrderSize) {
+      return RiskVerdict::OrderTooLarge;
+    }
+    // Market orders carry no price, so there is no notional to bound here.
+    if(command.orderType != OrderType::Market &&
+       static_cast<std::int64_t>(command.quantity) * command.price >
+           limits.maxOrderNotional) {
+      return RiskVerdict::NotionalTooLarge;
+    }
+    if(counters_[static_cast<std::size_t>(participant)].openOrders >=
+       limits.maxOpenOrders) {
+      return RiskVerdict::TooManyOpenOrders;
+    }
+    return RiskVerdict::Accept;
+  }
+
+  void Credit(ParticipantId participant, std::int64_t quantity) {
+    if(participant < 0 ||
+       static_cast<std::size_t>(participant) >= counters_.size()) {
+      return;
+    }
+    counters_[static_cast<std::size_t>(participant)].position += quantity;
+  }
+
+  // Works a tracked order's remaining quantity down; a full fill frees its
+  // open-order slot. Untracked ids (sweeping aggressors) just fall through.
+  void Decrement(OrderId orderId, Quantity quantity) {
+    OrderIndex* remaining = restingQuantity_.Find(orderId);
+    if(remaining == nullptr) return;
+    *remaining -= static_cast<OrderIndex>(quantity);
+    if(*remaining == 0) Retire(orderId);
+  }
+
+  void Retire(OrderId orderId) {
+    OrderIndex* owner = orderOwner_.Find(orderId);
+    if(owner == nullptr) return;
+    --counters_[*owner].openOrders;
+    orderOwner_.Erase(orderId);
+    restingQuantity_.Erase(orderId);
+  }
+
+  Book* book_;
+  std::vector<RiskLimits> limits_;
+  std::vector<Counters> counters_;
+  // OrderId -> owning participant / remaining quantity, in the same flat
+  // open-addressing tables the book uses for its own id index.
+  OrderIdIndex orderOwner_;
+  OrderIdIndex restingQuantity_;
+};
+
+#endif
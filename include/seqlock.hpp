@@ -0,0 +1,45 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+// Single-writer/multi-reader sequence lock. The writer bumps the sequence to
+// an odd value, copies the payload in, then bumps it even again; readers copy
+// the payload out and retry if the sequence changed (or was odd) while they
+// were reading. Readers never block the writer and the writer never waits.
+template <typename T>
+class Seqlock {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Seqlock payloads are copied byte-wise between threads");
+
+ public:
+  void Store(const T& value) {
+    std::uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    value_ = value;
+    std::atomic_thread_fence(std::memory_order_release);
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  T Load() const {
+    T value;
+    std::uint64_t before, after;
+    do {
+      before = sequence_.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      value = value_;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = sequence_.load(std::memory_order_relaxed);
+    } while(before != after || (before & 1));
+    return value;
+  }
+
+ private:
+  alignas(64) std::atomic<std::uint64_t> sequence_{0};
+  T value_{};
+};
+
+#endif
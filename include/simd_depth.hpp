@@ -0,0 +1,117 @@
+#ifndef SIMD_DEPTH_H
+#define SIMD_DEPTH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "orderbook.hpp"
+
+// Vectorized depth analytics. The kernels run over struct-of-arrays
+// price/quantity vectors so the SIMD lanes load contiguous same-typed data;
+// DepthArrays converts from the LevelInfos the book produces. Compiled
+// without AVX2 the same entry points fall back to scalar loops.
+
+struct DepthArrays {
+  std::vector<Price> prices;
+  std::vector<Quantity> quantities;
+
+  DepthArrays() = default;
+
+  explicit DepthArrays(const LevelInfos& levels) { Assign(levels); }
+
+  void Assign(const LevelInfos& levels) {
+    prices.resize(levels.size());
+    quantities.resize(levels.size());
+    for(std::size_t i = 0; i < levels.size(); ++i) {
+      prices[i] = levels[i].price;
+      quantities[i] = levels[i].quantity;
+    }
+  }
+
+  std::size_t Size() const { return prices.size(); };
+};
+
+// Sum of the first n quantities (cumulative size over the top-n levels).
+inline std::int64_t CumulativeQuantity(const Quantity* quantities,
+                                       std::size_t n) {
+  std::size_t i = 0;
+  std::int64_t sum = 0;
+#if defined(__AVX2__)
+  __m256i accumulator = _mm256_setzero_si256();
+  for(; i + 8 <= n; i += 8) {
+    __m256i lanes =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(quantities + i));
+    // Widen to 64-bit before accumulating so deep books can't overflow.
+    accumulator = _mm256_add_epi64(
+        accumulator, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(lanes)));
+    accumulator = _mm256_add_epi64(
+        accumulator,
+        _mm256_cvtepi32_epi64(_mm256_extracti128_si256(lanes, 1)));
+  }
+  alignas(32) std::int64_t partial[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(partial), accumulator);
+  sum = partial[0] + partial[1] + partial[2] + partial[3];
+#endif
+  for(; i < n; ++i) sum += quantities[i];
+  return sum;
+}
+
+// Notional sum (price * quantity) over the first n levels.
+inline std::int64_t Notional(const Price* prices, const Quantity* quantities,
+                             std::size_t n) {
+  std::size_t i = 0;
+  std::int64_t sum = 0;
+#if defined(__AVX2__)
+  __m256i accumulator = _mm256_setzero_si256();
+  for(; i + 4 <= n; i += 4) {
+    // 4 lanes of sign-extended 64-bit price * quantity products.
+    __m256i price64 = _mm256_cvtepi32_epi64(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(prices + i)));
+    __m256i quantity64 = _mm256_cvtepi32_epi64(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(quantities + i)));
+    // _mm256_mul_epi32 multiplies the low 32 bits of each 64-bit lane and
+    // produces the signed 64-bit product, which is exactly what the widened
+    // lanes hold.
+    accumulator =
+        _mm256_add_epi64(accumulator, _mm256_mul_epi32(price64, quantity64));
+  }
+  alignas(32) std::int64_t partial[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(partial), accumulator);
+  sum = partial[0] + partial[1] + partial[2] + partial[3];
+#endif
+  for(; i < n; ++i) {
+    sum += static_cast<std::int64_t>(prices[i]) * quantities[i];
+  }
+  return sum;
+}
+
+// Volume-weighted average price over the first n levels (0 on an empty
+// side).
+inline double Vwap(const DepthArrays& depth, std::size_t n) {
+  n = n < depth.Size() ? n : depth.Size();
+  std::int64_t quantity = CumulativeQuantity(depth.quantities.data(), n);
+  if(quantity == 0) return 0.0;
+  return static_cast<double>(
+             Notional(depth.prices.data(), depth.quantities.data(), n)) /
+         static_cast<double>(quantity);
+}
+
+// Top-n book imbalance in [-1, 1]: +1 all bid, -1 all ask.
+inline double Imbalance(const DepthArrays& bids, const DepthArrays& asks,
+                        std::size_t n) {
+  std::int64_t bidQuantity = CumulativeQuantity(
+      bids.quantities.data(), n < bids.Size() ? n : bids.Size());
+  std::int64_t askQuantity = CumulativeQuantity(
+      asks.quantities.data(), n < asks.Size() ? n : asks.Size());
+  std::int64_t total = bidQuantity + askQuantity;
+  if(total == 0) return 0.0;
+  return static_cast<double>(bidQuantity - askQuantity) /
+         static_cast<double>(total);
+}
+
+#endif
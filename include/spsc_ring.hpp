@@ -0,0 +1,69 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// Bounded lock-free single-producer/single-consumer ring. The producer and
+// consumer indices live on their own cache lines, and each side keeps a
+// cached copy of the other's index so the common case touches no shared
+// line at all. Capacity must be a power of two.
+template <typename T>
+class SpscRing {
+ public:
+  explicit SpscRing(std::size_t capacity)
+      : capacity_{capacity}, mask_{capacity - 1}, slots_(capacity) {
+    if(capacity == 0 || (capacity & (capacity - 1)) != 0) {
+      throw std::invalid_argument("SpscRing capacity must be a power of two");
+    }
+  }
+
+  // Producer side. Returns false when the ring is full.
+  bool TryPush(const T& value) {
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if(tail - cachedHead_ == capacity_) {
+      cachedHead_ = head_.load(std::memory_order_acquire);
+      if(tail - cachedHead_ == capacity_) return false;
+    }
+    slots_[tail & mask_] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side: invokes f on up to maxBatch queued values and returns how
+  // many were consumed. Slots are released in one index store at the end so
+  // the producer sees the whole batch freed at once.
+  template <typename F>
+  std::size_t Drain(F&& f, std::size_t maxBatch) {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    std::size_t available = cachedTail_ - head;
+    if(available == 0) {
+      cachedTail_ = tail_.load(std::memory_order_acquire);
+      available = cachedTail_ - head;
+      if(available == 0) return 0;
+    }
+    std::size_t count = std::min(available, maxBatch);
+    for(std::size_t i = 0; i < count; ++i) {
+      f(slots_[(head + i) & mask_]);
+    }
+    head_.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  std::size_t Capacity() const { return capacity_; };
+
+ private:
+  std::size_t capacity_;
+  std::size_t mask_;
+  std::vector<T> slots_;
+
+  alignas(64) std::atomic<std::size_t> tail_{0};  // producer writes
+  alignas(64) std::size_t cachedHead_{0};         // producer-local
+  alignas(64) std::atomic<std::size_t> head_{0};  // consumer writes
+  alignas(64) std::size_t cachedTail_{0};         // consumer-local
+};
+
+#endif
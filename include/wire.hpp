@@ -0,0 +1,151 @@
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "ingress.hpp"
+#include "orderbook.hpp"
+
+// Fixed-width little-endian order-entry wire format. Messages are packed
+// standard-layout structs so a receive buffer can be reinterpreted in place
+// and fed straight to the book - no text parsing, no intermediate
+// allocation. The first byte of every message is its WireType.
+
+enum class WireType : std::uint8_t { NewOrder = 1, Cancel = 2, Modify = 3 };
+
+#pragma pack(push, 1)
+
+struct WireNewOrder {
+  std::uint8_t type;       // WireType::NewOrder
+  std::uint8_t side;       // 0 = buy, 1 = sell
+  std::uint8_t orderType;  // OrderType enum value
+  std::uint8_t reserved;
+  OrderId orderId;
+  Quantity quantity;
+  Price price;
+};
+
+struct WireCancel {
+  std::uint8_t type;  // WireType::Cancel
+  std::uint8_t reserved[3];
+  OrderId orderId;
+};
+
+struct WireModify {
+  std::uint8_t type;  // WireType::Modify
+  std::uint8_t side;  // 0 = buy, 1 = sell
+  std::uint8_t reserved[2];
+  OrderId orderId;
+  Quantity quantity;
+  Price price;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(WireNewOrder) == 16);
+static_assert(sizeof(WireCancel) == 8);
+static_assert(sizeof(WireModify) == 16);
+static_assert(std::is_trivially_copyable_v<WireNewOrder>);
+static_assert(std::is_trivially_copyable_v<WireCancel>);
+static_assert(std::is_trivially_copyable_v<WireModify>);
+
+inline std::size_t WireMessageSize(WireType type) {
+  switch(type) {
+    case WireType::NewOrder:
+      return sizeof(WireNewOrder);
+    case WireType::Cancel:
+      return sizeof(WireCancel);
+    case WireType::Modify:
+      return sizeof(WireModify);
+  }
+  return 0;
+}
+
+// Decodes one message from the front of the buffer into an OrderCommand.
+// Returns the bytes consumed, or 0 when the buffer holds no complete valid
+// message (partial read: try again with more data).
+inline std::size_t DecodeCommand(const std::byte* data, std::size_t size,
+                                 OrderCommand& out) {
+  if(size < 1) return 0;
+  WireType type = static_cast<WireType>(std::to_integer<std::uint8_t>(*data));
+  std::size_t messageSize = WireMessageSize(type);
+  if(messageSize == 0 || size < messageSize) return 0;
+
+  switch(type) {
+    case WireType::NewOrder: {
+      const auto* wire = reinterpret_cast<const WireNewOrder*>(data);
+      out = OrderCommand{OrderCommand::Type::NewOrder,
+                         wire->side ? Side::Sell : Side::Buy,
+                         static_cast<OrderType>(wire->orderType),
+                         wire->orderId, wire->quantity, wire->price};
+      break;
+    }
+    case WireType::Cancel: {
+      const auto* wire = reinterpret_cast<const WireCancel*>(data);
+      out = OrderCommand{OrderCommand::Type::Cancel, Side::Buy,
+                         OrderType::GoodTillCancel, wire->orderId, 0, 0};
+      break;
+    }
+    case WireType::Modify: {
+      const auto* wire = reinterpret_cast<const WireModify*>(data);
+      out = OrderCommand{OrderCommand::Type::Modify,
+                         wire->side ? Side::Sell : Side::Buy,
+                         OrderType::GoodTillCancel, wire->orderId,
+                         wire->quantity, wire->price};
+      break;
+    }
+  }
+  return messageSize;
+}
+
+// Encodes a command into `out` (which must have room for 16 bytes) and
+// returns the encoded size. The inverse of DecodeCommand; the journal and
+// replay tooling reuse it.
+inline std::size_t EncodeCommand(const OrderCommand& command, std::byte* out) {
+  switch(command.type) {
+    case OrderCommand::Type::NewOrder: {
+      WireNewOrder wire{static_cast<std::uint8_t>(WireType::NewOrder),
+                        static_cast<std::uint8_t>(command.side == Side::Sell),
+                        static_cast<std::uint8_t>(command.orderType), 0,
+                        command.orderId, command.quantity, command.price};
+      std::memcpy(out, &wire, sizeof(wire));
+      return sizeof(wire);
+    }
+    case OrderCommand::Type::Cancel: {
+      WireCancel wire{static_cast<std::uint8_t>(WireType::Cancel),
+                      {0, 0, 0},
+                      command.orderId};
+      std::memcpy(out, &wire, sizeof(wire));
+      return sizeof(wire);
+    }
+    case OrderCommand::Type::Modify: {
+      WireModify wire{static_cast<std::uint8_t>(WireType::Modify),
+                      static_cast<std::uint8_t>(command.side == Side::Sell),
+                      {0, 0},
+                      command.orderId, command.quantity, command.price};
+      std::memcpy(out, &wire, sizeof(wire));
+      return sizeof(wire);
+    }
+  }
+  return 0;
+}
+
+// Applies every complete message in the buffer to the book and returns the
+// bytes consumed; the caller keeps any unconsumed tail for the next read.
+template <typename Book>
+std::size_t FeedWireBuffer(Book& book, const std::byte* data,
+                           std::size_t size) {
+  std::size_t consumed = 0;
+  OrderCommand command;
+  while(std::size_t n = DecodeCommand(data + consumed, size - consumed,
+                                      command)) {
+    ApplyCommand(book, command);
+    consumed += n;
+  }
+  return consumed;
+}
+
+#endif
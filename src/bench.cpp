@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ingress.hpp"
+#include "orderbook.hpp"
+
+// Synthetic workload generator and latency reporter for the order book.
+// Each workload is a weighted mix of passive adds, aggressive (crossing)
+// adds and cancels, with prices drawn from a zipfian distribution around a
+// mid so activity clusters at the touch like real flow does.
+
+namespace {
+
+  struct WorkloadConfig {
+    std::string name;
+    int passiveWeight;
+    int crossWeight;
+    int cancelWeight;
+  };
+
+  const std::vector<WorkloadConfig> kWorkloads{
+      {"passive-heavy", 80, 5, 15},
+      {"cross-heavy", 40, 40, 20},
+      {"cancel-heavy", 35, 5, 60},
+  };
+
+  constexpr std::size_t kOperations = 1'000'000;
+  constexpr Price kMidPrice = 10'000;
+  constexpr int kPriceLevels = 64;
+  constexpr double kZipfSkew = 1.2;
+
+  // Draws level offsets 0..kPriceLevels-1 with zipfian weight 1/(k+1)^skew,
+  // via a precomputed CDF: offset 0 (the touch) is by far the most likely.
+  class ZipfianOffset {
+   public:
+    ZipfianOffset() {
+      double runningSum = 0;
+      for(int k = 0; k < kPriceLevels; ++k) {
+        runningSum += 1.0 / std::pow(k + 1, kZipfSkew);
+        cdf_.push_back(runningSum);
+      }
+      for(double& value : cdf_) value /= runningSum;
+    }
+
+    int operator()(std::mt19937_64& rng) const {
+      double u = std::uniform_real_distribution<double>{0.0, 1.0}(rng);
+      return static_cast<int>(
+          std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin());
+    }
+
+   private:
+    std::vector<double> cdf_;
+  };
+
+  std::vector<OrderCommand> GenerateCommands(const WorkloadConfig& config,
+                                             std::mt19937_64& rng) {
+    std::vector<OrderCommand> commands;
+    commands.reserve(kOperations);
+    ZipfianOffset zipf;
+    std::uniform_int_distribution<int> weightDist{
+        0, config.passiveWeight + config.crossWeight + config.cancelWeight - 1};
+    std::uniform_int_distribution<Quantity> quantityDist{1, 100};
+
+    std::vector<OrderId> open;
+    OrderId nextId = 1;
+
+    for(std::size_t i = 0; i < kOperations; ++i) {
+      int roll = weightDist(rng);
+      bool sellSide = rng() & 1;
+      Side side = sellSide ? Side::Sell : Side::Buy;
+      int offset = zipf(rng);
+
+      if(roll < config.passiveWeight || open.empty()) {
+        // Rest away from the touch.
+        Price price = sellSide ? kMidPrice + 1 + offset : kMidPrice - 1 - offset;
+        commands.push_back(OrderCommand{OrderCommand::Type::NewOrder, side,
+                                        OrderType::GoodTillCancel, nextId,
+                                        quantityDist(rng), price});
+        open.push_back(nextId++);
+      } else if(roll < config.passiveWeight + config.crossWeight) {
+        // Cross the spread and take liquidity.
+        Price price = sellSide ? kMidPrice - 1 - offset : kMidPrice + 1 + offset;
+        commands.push_back(OrderCommand{OrderCommand::Type::NewOrder, side,
+                                        OrderType::GoodTillCancel, nextId++,
+                                        quantityDist(rng), price});
+      } else {
+        std::size_t victim =
+            std::uniform_int_distribution<std::size_t>{0, open.size() - 1}(rng);
+        commands.push_back(OrderCommand{OrderCommand::Type::Cancel, side,
+                                        OrderType::GoodTillCancel,
+                                        open[victim], 0, 0});
+        open[victim] = open.back();
+        open.pop_back();
+      }
+    }
+    return commands;
+  }
+
+  void RunWorkload(const WorkloadConfig& config) {
+    std::mt19937_64 rng{42};
+    std::vector<OrderCommand> commands = GenerateCommands(config, rng);
+
+    OrderBook book;
+    std::vector<std::uint64_t> latencies;
+    latencies.reserve(commands.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for(const OrderCommand& command : commands) {
+      auto before = std::chrono::steady_clock::now();
+      ApplyCommand(book, command);
+      auto after = std::chrono::steady_clock::now();
+      latencies.push_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(after - before)
+              .count());
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+      return latencies[static_cast<std::size_t>(p * (latencies.size() - 1))];
+    };
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << config.name << ": " << commands.size() / seconds / 1e6
+              << " Mops/s, p50 " << percentile(0.50) << " ns, p99 "
+              << percentile(0.99) << " ns, p99.9 " << percentile(0.999)
+              << " ns\n";
+  }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  for(const WorkloadConfig& config : kWorkloads) {
+    if(argc > 1 && config.name != argv[1]) continue;
+    RunWorkload(config);
+  }
+  return 0;
+}